@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+// Times the native part of every XtractOctave function, without the Octave
+// interpreter in the way, for frame sizes from 64 to 65536 samples.
+//
+// usage: native_benchmark [output.csv [minimum seconds per measurement]]
+//
+// The results are written as CSV with the same columns as
+// bench/xtract_benchmark.m so the two can be compared directly.
+
+#include "../common/analysis.h"
+#include "../common/autocorrelation.h"
+#include "../common/difference_functions.h"
+#include "../common/features.h"
+#include <xtract/libxtract.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const double sampleRate = 44100;
+    const double f0 = 440;
+    const int minFrameSize = 64;
+    const int maxFrameSize = 65536;
+
+    // a harmonic tone with a little noise, so the peak and harmonic
+    // features have something to find
+    std::vector<double> makeSignal (int length)
+    {
+        std::vector<double> signal (length);
+        srand (1);
+
+        for (int i = 0; i < length; ++i)
+        {
+            double t = i / sampleRate;
+            signal [i] = 0;
+
+            for (int harmonic = 1; harmonic <= 8; ++harmonic)
+            {
+                signal [i] += sin (2 * M_PI * harmonic * f0 * t) / harmonic;
+            }
+
+            signal [i] += 0.01 * (2.0 * rand() / RAND_MAX - 1);
+        }
+
+        return signal;
+    }
+
+    // call function repeatedly for at least minimumTime seconds and write a
+    // line of results
+    void timeFunction (FILE* output, const std::string& name, int frameSize,
+                       double minimumTime, const std::function<void()>& function)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        // warm up any caches and plans
+        function();
+
+        long calls = 0;
+        long batch = 1;
+        double seconds = 0;
+        Clock::time_point start = Clock::now();
+
+        while (seconds < minimumTime)
+        {
+            for (long i = 0; i < batch; ++i)
+            {
+                function();
+            }
+
+            calls += batch;
+            batch *= 2;
+            seconds = std::chrono::duration<double> (Clock::now() - start).count();
+        }
+
+        double callsPerSecond = calls / seconds;
+        double nsPerSample = 1e9 * seconds / ((double) calls * frameSize);
+
+        fprintf (output, "native,%s,%d,%ld,%.6f,%.3f,%.3f\n",
+                 name.c_str(), frameSize, calls, seconds, callsPerSecond, nsPerSample);
+        fflush (output);
+    }
+}
+
+int main (int argc, char* argv [])
+{
+    FILE* output = stdout;
+    double minimumTime = 0.2;
+
+    if (argc > 1)
+    {
+        output = fopen (argv [1], "w");
+
+        if (output == NULL)
+        {
+            fprintf (stderr, "couldn't open %s for writing\n", argv [1]);
+            return 1;
+        }
+    }
+
+    if (argc > 2)
+    {
+        minimumTime = atof (argv [2]);
+    }
+
+    fprintf (output, "driver,function,frame_size,calls,seconds,calls_per_second,ns_per_sample\n");
+
+    std::vector<std::string> featureNames = XtractOctave::getFeatureNames();
+
+    for (int frameSize = minFrameSize; frameSize <= maxFrameSize; frameSize *= 2)
+    {
+        std::vector<double> signal = makeSignal (frameSize);
+        const double* frame = &signal [0];
+        XtractOctave::FrameAnalysis analysis (frameSize, sampleRate);
+        std::vector<double> result (2 * frameSize);
+
+        // the features shared with xtract_features, each found from scratch
+        // as the wrapper of the same name would
+        for (size_t i = 0; i < featureNames.size(); ++i)
+        {
+            const XtractOctave::Feature* feature = XtractOctave::findFeature (featureNames [i]);
+
+            timeFunction (output, featureNames [i], frameSize, minimumTime, [&] ()
+            {
+                analysis.setFrame (frame, f0);
+                feature->extract (analysis, &result [0]);
+            });
+        }
+
+        // all of them in one pass, as xtract_features does
+        timeFunction (output, "features", frameSize, minimumTime, [&] ()
+        {
+            analysis.setFrame (frame, f0);
+
+            for (size_t i = 0; i < featureNames.size(); ++i)
+            {
+                XtractOctave::findFeature (featureNames [i])->extract (analysis, &result [0]);
+            }
+        });
+
+        // the time domain functions which aren't features
+        timeFunction (output, "f0", frameSize, minimumTime, [&] ()
+        {
+            double sampleRateToUse = sampleRate;
+            xtract_f0 (frame, frameSize, &sampleRateToUse, &result [0]);
+        });
+
+        timeFunction (output, "wavelet_f0", frameSize, minimumTime, [&] ()
+        {
+            double sampleRateToUse = sampleRate;
+            xtract_init_wavelet_f0_state();
+            xtract_wavelet_f0 (frame, frameSize, &sampleRateToUse, &result [0]);
+        });
+
+        timeFunction (output, "amdf", frameSize, minimumTime, [&] ()
+        {
+            xtract_amdf (frame, frameSize, NULL, &result [0]);
+        });
+
+        XtractOctave::Autocorrelator autocorrelator (frameSize, frameSize);
+
+        timeFunction (output, "asdf", frameSize, minimumTime, [&] ()
+        {
+            XtractOctave::findASDF (frame, frameSize, autocorrelator, &result [0]);
+        });
+
+        std::vector<double> autocorrelation (frameSize);
+        std::vector<double> lpc (2 * (frameSize - 1));
+        double order = round (1.5 * (frameSize - 1));
+        std::vector<double> lpcc (order);
+
+        timeFunction (output, "lpc", frameSize, minimumTime, [&] ()
+        {
+            autocorrelator.process (frame, &autocorrelation [0]);
+            xtract_lpc (&autocorrelation [0], frameSize, NULL, &lpc [0]);
+        });
+
+        timeFunction (output, "lpcc", frameSize, minimumTime, [&] ()
+        {
+            autocorrelator.process (frame, &autocorrelation [0]);
+            xtract_lpc (&autocorrelation [0], frameSize, NULL, &lpc [0]);
+            xtract_lpcc (&lpc [frameSize - 1], frameSize - 1, &order, &lpcc [0]);
+        });
+    }
+
+    if (output != stdout)
+    {
+        fclose (output);
+    }
+
+    return 0;
+}
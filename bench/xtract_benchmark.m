@@ -0,0 +1,143 @@
+## Copyright (C) 2014 Sean Enderby
+##
+## Permission is hereby granted, free of charge, to any person obtaining a copy
+## of this software and associated documentation files (the "Software"), to
+## deal in the Software without restriction, including without limitation the
+## rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+## sell copies of the Software, and to permit persons to whom the Software is
+## furnished to do so, subject to the following conditions:
+##
+## The above copyright notice and this permission notice shall be included in
+## all copies or substantial portions of the Software.
+##
+## THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+## IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+## FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+## AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+## LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+## FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+## IN THE SOFTWARE.
+
+## -*- texinfo -*-
+## @deftypefn {Function File} {@var{results} =} xtract_benchmark ()
+## @deftypefnx {Function File} {@var{results} =} xtract_benchmark (@var{filename})
+## @deftypefnx {Function File} {@var{results} =} xtract_benchmark (@var{filename}, @var{sizes})
+## @deftypefnx {Function File} {@var{results} =} xtract_benchmark (@var{filename}, @var{sizes}, @var{mintime})
+## Time every XtractOctave function on frames of each of the lengths in
+## @var{sizes} (64 to 65536 by default).
+##
+## Each function is called repeatedly until at least @var{mintime} seconds
+## (0.2 by default) have passed. The results are written to @var{filename}
+## as CSV with the columns driver, function, frame_size, calls, seconds,
+## calls_per_second and ns_per_sample, which are the same as the output of
+## bench/native_benchmark so the cost of the Octave interface can be seen.
+## If no @var{filename} is given the results are only returned, as a struct
+## array with a field for each column.
+##
+## The .oct files must be on the load path, run from the top of the
+## repository with @code{addpath ("bench")} or use @code{make bench}.
+##
+## The autocorrelation based functions (amdf, asdf, lpc and lpcc) take
+## quadratic time so the largest frame sizes take a few seconds each.
+## @end deftypefn
+
+function results = xtract_benchmark (filename = "", sizes = 2 .^ (6:16), mintime = 0.2)
+
+  fs = 44100;
+  f0 = 440;
+
+  ## each function with the arguments it is called with, the frame is
+  ## passed in as the first argument
+  functions = {
+    "amdf",                        {};
+    "asdf",                        {};
+    "bark",                        {fs};
+    "crest",                       {};
+    "f0",                          {fs};
+    "features",                    {fs, {"spectral_centroid", "spread", "flatness", "loudness", "mfcc"}};
+    "flatness",                    {};
+    "harmonic_features",           {fs, f0};
+    "hps",                         {fs};
+    "irregularity",                {"k"};
+    "loudness",                    {fs};
+    "lpc",                         {};
+    "lpcc",                        {};
+    "mfcc",                        {fs};
+    "noisiness",                   {fs, f0};
+    "odd_even_ratio",              {fs, f0};
+    "peaks",                       {fs};
+    "power",                       {};
+    "rolloff",                     {85};
+    "sharpness",                   {fs};
+    "smoothness",                  {};
+    "spectral_centroid",           {fs};
+    "spectral_inharmonicity",      {fs, f0};
+    "spectral_kurtosis",           {fs};
+    "spectral_skewness",           {fs};
+    "spectral_slope",              {};
+    "spectral_standard_deviation", {fs};
+    "spectral_variance",           {fs};
+    "spread",                      {fs};
+    "tonality",                    {};
+    "tristimulus",                 {fs, 1};
+    "wavelet_f0",                  {fs};
+    "zcr",                         {};
+  };
+
+  results = struct ("driver", {}, "function", {}, "frame_size", {}, "calls", {},
+                    "seconds", {}, "calls_per_second", {}, "ns_per_sample", {});
+
+  for size = sizes
+    ## a harmonic tone with a little noise, as the native benchmark uses
+    t = (0:size - 1)' / fs;
+    frame = sin (2 * pi * f0 * t * (1:8)) * (1 ./ (1:8))';
+    rand ("seed", 1);
+    frame += 0.01 * (2 * rand (size, 1) - 1);
+
+    for i = 1:rows (functions)
+      name = ["xtract_" functions{i, 1}];
+      arguments = functions(i, 2){1};
+
+      ## warm up any caches and plans
+      feval (name, frame, arguments{:});
+
+      calls = 0;
+      batch = 1;
+      seconds = 0;
+      start = tic ();
+
+      while (seconds < mintime)
+        for j = 1:batch
+          feval (name, frame, arguments{:});
+        endfor
+
+        calls += batch;
+        batch *= 2;
+        seconds = toc (start);
+      endwhile
+
+      results(end + 1) = struct ("driver", "octave", "function", functions{i, 1},
+                                 "frame_size", size, "calls", calls, "seconds", seconds,
+                                 "calls_per_second", calls / seconds,
+                                 "ns_per_sample", 1e9 * seconds / (calls * size));
+    endfor
+  endfor
+
+  if (! isempty (filename))
+    fid = fopen (filename, "w");
+
+    if (fid < 0)
+      error ("xtract_benchmark: couldn't open %s for writing", filename);
+    endif
+
+    fprintf (fid, "driver,function,frame_size,calls,seconds,calls_per_second,ns_per_sample\n");
+
+    for r = results
+      fprintf (fid, "%s,%s,%d,%d,%.6f,%.3f,%.3f\n", r.driver, r.function, r.frame_size,
+               r.calls, r.seconds, r.calls_per_second, r.ns_per_sample);
+    endfor
+
+    fclose (fid);
+  endif
+
+endfunction
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "analysis.h"
+#include "bark.h"
+#include "mel_filters.h"
+#include "scratch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace XtractOctave
+{
+    FrameAnalysis::FrameAnalysis (int inputLengthToUse, double sampleRateToUse, const double* window,
+                                  bool privatePlan, int thread, int fftLength,
+                                  bool singlePrecision)
+      : analyser (inputLengthToUse, sampleRateToUse, window, privatePlan, thread, fftLength, singlePrecision),
+        inputLength (inputLengthToUse),
+        paddedLength (analyser.getPaddedLength()),
+        sampleRate (sampleRateToUse),
+        harmonicThreshold (0.2),
+        rolloffThreshold (85),
+        frame (NULL),
+        singleFrame (NULL),
+        widenedFrame (getScratch (frameBuffer, inputLength, thread)),
+        f0 (0),
+        inputIsSpectrum (false),
+        spectrum (NULL),
+        spectralMean (0),
+        spectralVariance (0),
+        haveSpectralMoments (false),
+        peakPicker (paddedLength, analyser.getSampleRateByN()),
+        peaks (getScratch (peaksBuffer, paddedLength, thread)),
+        havePeaks (false),
+        harmonics (getScratch (harmonicsBuffer, paddedLength, thread)),
+        haveHarmonics (false),
+        barkBandLimits (NULL),
+        haveBarkCoefficients (false)
+    {
+    }
+
+    void FrameAnalysis::setFrame (const double* frameToUse, double f0ToUse)
+    {
+        frame = frameToUse;
+        singleFrame = NULL;
+        f0 = f0ToUse;
+
+        spectrum = NULL;
+        haveSpectralMoments = false;
+        havePeaks = false;
+        haveHarmonics = false;
+        haveBarkCoefficients = false;
+    }
+
+    void FrameAnalysis::setFrame (const float* frameToUse, double f0ToUse)
+    {
+        setFrame ((const double*) NULL, f0ToUse);
+        singleFrame = frameToUse;
+    }
+
+    void FrameAnalysis::setInputIsSpectrum (bool isSpectrum)
+    {
+        inputIsSpectrum = isSpectrum;
+    }
+
+    void FrameAnalysis::setHarmonicThreshold (double threshold)
+    {
+        harmonicThreshold = threshold;
+        haveHarmonics = false;
+    }
+
+    void FrameAnalysis::setRolloffThreshold (double threshold)
+    {
+        rolloffThreshold = threshold;
+    }
+
+    void FrameAnalysis::setPeakPicking (double threshold, int maxPeaks)
+    {
+        peakPicker = PeakPicker (paddedLength, getSampleRateByN(), threshold, maxPeaks);
+        havePeaks = false;
+        haveHarmonics = false;
+    }
+
+    int FrameAnalysis::getInputLength() const
+    {
+        return inputLength;
+    }
+
+    int FrameAnalysis::getPaddedLength() const
+    {
+        return paddedLength;
+    }
+
+    double FrameAnalysis::getSampleRate() const
+    {
+        return sampleRate;
+    }
+
+    double FrameAnalysis::getSampleRateByN() const
+    {
+        return analyser.getSampleRateByN();
+    }
+
+    double FrameAnalysis::getF0() const
+    {
+        return f0;
+    }
+
+    double FrameAnalysis::getRolloffThreshold() const
+    {
+        return rolloffThreshold;
+    }
+
+    const double* FrameAnalysis::getFrame()
+    {
+        if (frame == NULL && singleFrame != NULL)
+        {
+            std::copy (singleFrame, singleFrame + inputLength, widenedFrame);
+            frame = widenedFrame;
+        }
+
+        return frame;
+    }
+
+    const double* FrameAnalysis::getSpectrum()
+    {
+        if (spectrum == NULL)
+        {
+            if (inputIsSpectrum)
+            {
+                spectrum = getFrame();
+            }
+            else if (singleFrame != NULL)
+            {
+                spectrum = analyser.findSpectrum (singleFrame);
+            }
+            else
+            {
+                spectrum = analyser.findSpectrum (frame);
+            }
+        }
+
+        return spectrum;
+    }
+
+    double FrameAnalysis::getSpectralMean()
+    {
+        if (! haveSpectralMoments)
+        {
+            xtract_spectral_mean (getSpectrum(), paddedLength, NULL, &spectralMean);
+            xtract_spectral_variance (getSpectrum(), paddedLength, &spectralMean, &spectralVariance);
+            haveSpectralMoments = true;
+        }
+
+        return spectralMean;
+    }
+
+    double FrameAnalysis::getSpectralVariance()
+    {
+        getSpectralMean();
+        return spectralVariance;
+    }
+
+    const double* FrameAnalysis::getPeaks()
+    {
+        if (! havePeaks)
+        {
+            peakPicker.findPeaks (getSpectrum(), peaks);
+            havePeaks = true;
+        }
+
+        return peaks;
+    }
+
+    const double* FrameAnalysis::getHarmonics()
+    {
+        if (! haveHarmonics)
+        {
+            double argumentArray [2] = {f0, harmonicThreshold};
+            xtract_harmonic_spectrum (getPeaks(), getPeakSpectrumLength(), argumentArray, harmonics);
+            haveHarmonics = true;
+        }
+
+        return harmonics;
+    }
+
+    int FrameAnalysis::getPeakSpectrumLength() const
+    {
+        return peakPicker.getPeakSpectrumLength();
+    }
+
+    bool FrameAnalysis::hasSparsePeaks() const
+    {
+        return peakPicker.isSparse();
+    }
+
+    const double* FrameAnalysis::getPartials()
+    {
+        return (f0 > 0) ? getHarmonics() : getPeaks();
+    }
+
+    const double* FrameAnalysis::getBarkCoefficients()
+    {
+        if (barkBandLimits == NULL)
+        {
+            barkBandLimits = getBarkBandLimits (paddedLength, sampleRate);
+        }
+
+        if (! haveBarkCoefficients)
+        {
+            barkCoefficients.resize (XTRACT_BARK_BANDS - 1);
+            findBarkCoefficients (getSpectrum(), barkBandLimits, &barkCoefficients [0]);
+            haveBarkCoefficients = true;
+        }
+
+        return &barkCoefficients [0];
+    }
+
+    xtract_mel_filter* FrameAnalysis::getMelFilters()
+    {
+        // the same filters xtract_mfcc uses by default
+        return XtractOctave::getMelFilters (paddedLength, sampleRate, 13, 20, 20000, XTRACT_EQUAL_GAIN);
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_ANALYSIS_H
+#define XTRACT_OCTAVE_ANALYSIS_H
+
+#include "peaks.h"
+#include "spectrum.h"
+#include <xtract/libxtract.h>
+#include <vector>
+
+namespace XtractOctave
+{
+    // The intermediate results which several features are calculated from.
+    //
+    // Each intermediate (the spectrum, the spectral mean and variance, the
+    // peak and harmonic spectra, and the bark coefficients) is only found
+    // the first time it is asked for after a new frame is set, so any number
+    // of features can share them.
+    class FrameAnalysis
+    {
+    public:
+        // privatePlan gives the analysis its own fft plan so it can be used
+        // off the main thread, and thread picks the scratch arena its
+        // buffers come from, fftLength the padded length (0 for the next
+        // power of 2) and singlePrecision the precision of the fft (see
+        // SpectrumAnalyser)
+        FrameAnalysis (int inputLength, double sampleRate, const double* window = NULL,
+                       bool privatePlan = false, int thread = 0, int fftLength = 0,
+                       bool singlePrecision = false);
+
+        // start analysing a new frame, f0 is only used by the harmonic features
+        void setFrame (const double* frame, double f0);
+
+        // the same for a single precision frame, its spectrum is found from
+        // it directly and it is only widened to double if a feature needs
+        // the signal itself
+        void setFrame (const float* frame, double f0);
+
+        // treat each frame as a spectrum laid out as xtract_spectrum lays
+        // it out (paddedLength long) rather than a signal
+        void setInputIsSpectrum (bool isSpectrum);
+
+        // the threshold used when finding the harmonic partials (0.2 by default)
+        void setHarmonicThreshold (double threshold);
+
+        // the rolloff threshold as a percentage (85 by default)
+        void setRolloffThreshold (double threshold);
+
+        // how the spectral peaks are found, threshold as a percentage of
+        // the largest magnitude (10 by default) and maxPeaks the number of
+        // the largest peaks to keep (0, the default, keeps them all and
+        // lays them out as xtract_peak_spectrum does, see PeakPicker)
+        void setPeakPicking (double threshold, int maxPeaks);
+
+        int getInputLength() const;
+        int getPaddedLength() const;
+        double getSampleRate() const;
+        double getSampleRateByN() const;
+        double getF0() const;
+        double getRolloffThreshold() const;
+        const double* getFrame();
+
+        const double* getSpectrum();
+        double getSpectralMean();
+        double getSpectralVariance();
+        const double* getPeaks();
+        const double* getHarmonics();
+
+        // the length of the peak and harmonic spectra, paddedLength unless
+        // only the largest peaks are kept
+        int getPeakSpectrumLength() const;
+        bool hasSparsePeaks() const;
+
+        // the harmonics if an f0 was given for this frame, otherwise all
+        // the spectral peaks (as xtract_tristimulus does without an f0)
+        const double* getPartials();
+        const double* getBarkCoefficients();
+        xtract_mel_filter* getMelFilters();
+
+    private:
+        SpectrumAnalyser analyser;
+        int inputLength;
+        int paddedLength;
+        double sampleRate;
+        double harmonicThreshold;
+        double rolloffThreshold;
+
+        const double* frame;
+        const float* singleFrame;
+        double* widenedFrame;
+        double f0;
+        bool inputIsSpectrum;
+
+        const double* spectrum;
+        double spectralMean;
+        double spectralVariance;
+        bool haveSpectralMoments;
+        PeakPicker peakPicker;
+        double* peaks;
+        bool havePeaks;
+        double* harmonics;
+        bool haveHarmonics;
+        const int* barkBandLimits;
+        std::vector<double> barkCoefficients;
+        bool haveBarkCoefficients;
+    };
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "audio_file.h"
+#include "wav_reader.h"
+
+namespace XtractOctave
+{
+    namespace
+    {
+        const AudioFormat formats [] =
+        {
+            {"wav", openWavFile}
+        };
+
+        const int numFormats = sizeof (formats) / sizeof (formats [0]);
+    }
+
+    AudioReader* openAudioFile (const std::string& path, std::string& problem)
+    {
+        problem.clear();
+
+        for (int i = 0; i < numFormats; ++i)
+        {
+            AudioReader* reader = formats [i].open (path, problem);
+
+            if (reader != NULL || ! problem.empty())
+            {
+                return reader;
+            }
+        }
+
+        problem = "it isn't in a format which can be read";
+        return NULL;
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_AUDIO_FILE_H
+#define XTRACT_OCTAVE_AUDIO_FILE_H
+
+#include <string>
+
+namespace XtractOctave
+{
+    // Reads the samples of an audio file a stretch at a time, so a file of
+    // any length can be analysed without holding all of it in memory.
+    class AudioReader
+    {
+    public:
+        virtual ~AudioReader() {}
+
+        virtual double getSampleRate() const = 0;
+        virtual int getNumChannels() const = 0;
+
+        // the number of samples in each channel
+        virtual long getLength() const = 0;
+
+        // read length samples from start on, mixing the channels down to
+        // one by averaging them, anything past the end of the file is zero
+        virtual void read (long start, int length, double* samples) = 0;
+    };
+
+    // A file format which can be read. open returns NULL if the file isn't
+    // in this format, or if it is but can't be read, in which case problem
+    // says why.
+    struct AudioFormat
+    {
+        const char* name;
+        AudioReader* (*open) (const std::string& path, std::string& problem);
+    };
+
+    // Open an audio file with the first format which recognises it, returns
+    // NULL (with problem saying why) if none of them can read it. Further
+    // formats only need adding to the list in audio_file.cpp.
+    AudioReader* openAudioFile (const std::string& path, std::string& problem);
+}
+
+#endif
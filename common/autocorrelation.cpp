@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "autocorrelation.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace XtractOctave
+{
+    Autocorrelator::Autocorrelator (int inputLengthToUse, int numLagsToUse)
+      : inputLength (inputLengthToUse),
+        numLags (std::min (numLagsToUse, inputLengthToUse)),
+        fftLength (findFFTLength (2 * inputLengthToUse, "fast"))
+    {
+        // a rough comparison of the work done each way
+        double directCost = (double) numLags * inputLength;
+        double fftCost = 10.0 * fftLength * log2 (fftLength);
+
+        if (directCost > fftCost)
+        {
+            fft.reset (new RealFFT (fftLength));
+            padded.assign (fftLength, 0);
+            bins.resize (fftLength / 2 + 1);
+        }
+    }
+
+    void Autocorrelator::process (const double* input, double* result)
+    {
+        if (! fft)
+        {
+            for (int lag = 0; lag < numLags; ++lag)
+            {
+                double correlation = 0;
+
+                for (int i = 0; i < inputLength - lag; ++i)
+                {
+                    correlation += input [i] * input [i + lag];
+                }
+
+                result [lag] = correlation / inputLength;
+            }
+
+            return;
+        }
+
+        // the padding is at least as long as the frame so the circular
+        // correlation the fft gives doesn't wrap round
+        std::memcpy (&padded [0], input, inputLength * sizeof (double));
+        std::fill (padded.begin() + inputLength, padded.end(), 0.0);
+
+        fft->transform (&padded [0], &bins [0]);
+
+        // the power spectrum is real and symmetric, so its inverse fft is
+        // the real part of its forward fft divided by the length
+        int halfLength = fftLength / 2;
+
+        for (int k = 0; k <= halfLength; ++k)
+        {
+            padded [k] = std::norm (bins [k]);
+        }
+
+        for (int k = 1; k < halfLength; ++k)
+        {
+            padded [fftLength - k] = padded [k];
+        }
+
+        fft->transform (&padded [0], &bins [0]);
+
+        double scale = 1.0 / ((double) fftLength * inputLength);
+
+        for (int lag = 0; lag < numLags; ++lag)
+        {
+            result [lag] = bins [lag].real() * scale;
+        }
+    }
+
+    int Autocorrelator::getNumLags() const
+    {
+        return numLags;
+    }
+}
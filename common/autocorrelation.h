@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_AUTOCORRELATION_H
+#define XTRACT_OCTAVE_AUTOCORRELATION_H
+
+#include "fft.h"
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace XtractOctave
+{
+    // Finds the autocorrelation of frames of a fixed length, scaled as
+    // xtract_autocorrelation scales it (divided by the frame length), for
+    // the first numLags lags only.
+    //
+    // xtract_autocorrelation always finds every lag directly, which takes
+    // O(N^2) time. When only a few lags are needed they are still found
+    // directly, otherwise the frame is zero padded to at least twice its
+    // length and the autocorrelation found from its power spectrum in
+    // O(N log N) time.
+    class Autocorrelator
+    {
+    public:
+        Autocorrelator (int inputLength, int numLags);
+
+        // result must have room for numLags values
+        void process (const double* input, double* result);
+
+        int getNumLags() const;
+
+    private:
+        int inputLength;
+        int numLags;
+        int fftLength;
+
+        // only used when the lags are found through an fft
+        std::unique_ptr<RealFFT> fft;
+        std::vector<double> padded;
+        std::vector<std::complex<double> > bins;
+    };
+}
+
+#endif
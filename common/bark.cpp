@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "bark.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        typedef std::pair<int, double> BarkBandKey;
+
+        std::map<BarkBandKey, std::vector<int> > barkBandCache;
+
+        // the cache is shared between the threads of a batch
+        std::mutex barkBandCacheMutex;
+    }
+
+    const int* getBarkBandLimits (int paddedLength, double sampleRate)
+    {
+        BarkBandKey key (paddedLength, sampleRate);
+        std::lock_guard<std::mutex> lock (barkBandCacheMutex);
+
+        std::map<BarkBandKey, std::vector<int> >::iterator cached = barkBandCache.find (key);
+
+        if (cached != barkBandCache.end())
+        {
+            return &cached->second [0];
+        }
+
+        std::vector<int>& limits = barkBandCache [key];
+        limits.resize (XTRACT_BARK_BANDS);
+        xtract_init_bark (paddedLength, sampleRate, &limits [0]);
+
+        for (int band = 0; band < XTRACT_BARK_BANDS; ++band)
+        {
+            limits [band] = std::min (limits [band], paddedLength / 2);
+        }
+
+        return &limits [0];
+    }
+
+    void findBarkCoefficients (const double* spectrum, const int* bandLimits, double* result)
+    {
+        for (int band = 0; band < XTRACT_BARK_BANDS - 1; ++band)
+        {
+            const double* magnitudes = spectrum + bandLimits [band];
+            int bandLength = bandLimits [band + 1] - bandLimits [band];
+
+            // four independent sums so the compiler can vectorise the loop
+            // without being allowed to reorder the additions itself
+            double sums [4] = {0, 0, 0, 0};
+            int n = 0;
+
+            for (; n + 4 <= bandLength; n += 4)
+            {
+                sums [0] += magnitudes [n];
+                sums [1] += magnitudes [n + 1];
+                sums [2] += magnitudes [n + 2];
+                sums [3] += magnitudes [n + 3];
+            }
+
+            double sum = (sums [0] + sums [1]) + (sums [2] + sums [3]);
+
+            for (; n < bandLength; ++n)
+            {
+                sum += magnitudes [n];
+            }
+
+            result [band] = sum;
+        }
+    }
+
+    void clearBarkBandCache()
+    {
+        std::lock_guard<std::mutex> lock (barkBandCacheMutex);
+        barkBandCache.clear();
+    }
+}
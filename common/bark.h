@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_BARK_H
+#define XTRACT_OCTAVE_BARK_H
+
+#include <xtract/libxtract.h>
+
+namespace XtractOctave
+{
+    // Get the limits of the bark bands for spectra paddedLength samples
+    // long, XTRACT_BARK_BANDS bin indices.
+    //
+    // The limits are found with xtract_init_bark the first time a length
+    // and sample rate are asked for and kept for the rest of the session.
+    // Unlike xtract_init_bark's they never go past the last magnitude of
+    // the spectrum, so low sample rates just leave the top bands empty.
+    const int* getBarkBandLimits (int paddedLength, double sampleRate);
+
+    // Sum the magnitudes of a spectrum laid out as xtract_spectrum lays it
+    // out into its XTRACT_BARK_BANDS - 1 bark coefficients, as
+    // xtract_bark_coefficients does.
+    void findBarkCoefficients (const double* spectrum, const int* bandLimits, double* result);
+
+    // Free all the bark band limits which have been found.
+    void clearBarkBandCache();
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "difference_functions.h"
+#include <algorithm>
+#include <cmath>
+
+namespace XtractOctave
+{
+    void findAMDF (const double* input, int inputLength, int numLags, double* result)
+    {
+        for (int lag = 0; lag < numLags; ++lag)
+        {
+            double difference = 0;
+
+            for (int i = 0; i < inputLength - lag; ++i)
+            {
+                difference += fabs (input [i] - input [i + lag]);
+            }
+
+            result [lag] = difference / inputLength;
+        }
+    }
+
+    void findASDF (const double* input, int inputLength, Autocorrelator& autocorrelator, double* result)
+    {
+        int numLags = autocorrelator.getNumLags();
+
+        // result holds the autocorrelation, which is already divided by
+        // the frame length, until each lag is overwritten
+        autocorrelator.process (input, result);
+
+        double energy = 0;
+
+        for (int i = 0; i < inputLength; ++i)
+        {
+            energy += input [i] * input [i];
+        }
+
+        // the energy of the first and last inputLength - lag samples
+        double headEnergy = energy;
+        double tailEnergy = energy;
+
+        for (int lag = 0; lag < numLags; ++lag)
+        {
+            double difference = (headEnergy + tailEnergy) / inputLength - 2 * result [lag];
+
+            // rounding can leave a tiny negative value where the difference is 0
+            result [lag] = std::max (difference, 0.0);
+
+            headEnergy -= input [inputLength - 1 - lag] * input [inputLength - 1 - lag];
+            tailEnergy -= input [lag] * input [lag];
+        }
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_DIFFERENCE_FUNCTIONS_H
+#define XTRACT_OCTAVE_DIFFERENCE_FUNCTIONS_H
+
+#include "autocorrelation.h"
+
+namespace XtractOctave
+{
+    // The average magnitude difference function of a frame for the first
+    // numLags lags, found directly as xtract_amdf finds it but without
+    // working out the lags beyond them.
+    void findAMDF (const double* input, int inputLength, int numLags, double* result);
+
+    // The average square difference function of a frame for the lags the
+    // autocorrelator was set up for, scaled as xtract_asdf scales it.
+    //
+    // Rather than summing the squared differences for each lag this uses
+    //
+    //     sum (x[i] - x[i + lag])^2 = sum x[i]^2 + sum x[i + lag]^2 - 2 r[lag]
+    //
+    // where the first two sums run over the overlapping samples (so are
+    // found from running totals) and r is the autocorrelation, which the
+    // autocorrelator finds through an fft when there are many lags.
+    void findASDF (const double* input, int inputLength, Autocorrelator& autocorrelator, double* result);
+}
+
+#endif
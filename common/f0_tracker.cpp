@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "f0_tracker.h"
+#include "scratch.h"
+#include <xtract/libxtract.h>
+#include <algorithm>
+#include <memory>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        // the tracker whose state LibXtract's wavelet f0 state currently holds
+        const F0Tracker* waveletStateOwner = NULL;
+
+        HandleRegistry<F0Tracker> f0Trackers;
+    }
+
+    F0Tracker::F0Tracker (double sampleRateToUse, int frameSizeToUse, int hopSizeToUse, Method methodToUse)
+      : sampleRate (sampleRateToUse),
+        frameSize (frameSizeToUse),
+        hopSize (hopSizeToUse),
+        method (methodToUse),
+        buffer (frameSizeToUse),
+        numBuffered (0),
+        numToSkip (0)
+    {
+    }
+
+    F0Tracker::~F0Tracker()
+    {
+        if (waveletStateOwner == this)
+        {
+            waveletStateOwner = NULL;
+        }
+    }
+
+    void F0Tracker::process (const double* samples, int numSamples, std::vector<double>& f0s)
+    {
+        // the spectral method needs an analyser for frames xtract_f0 can't
+        // manage, it only lives for this chunk as its buffers are shared
+        std::unique_ptr<SpectrumAnalyser> analyser;
+        double* peaks = NULL;
+
+        if (method == spectralMethod)
+        {
+            analyser.reset (new SpectrumAnalyser (frameSize, sampleRate));
+            peaks = getScratch (peaksBuffer, analyser->getPaddedLength());
+        }
+
+        while (numSamples > 0)
+        {
+            // skip the gap between frames
+            if (numToSkip > 0)
+            {
+                int skip = std::min (numToSkip, numSamples);
+                samples += skip;
+                numSamples -= skip;
+                numToSkip -= skip;
+                continue;
+            }
+
+            const double* frame = NULL;
+
+            if (numBuffered == 0 && numSamples >= frameSize)
+            {
+                // the whole frame is in this chunk so use it where it is
+                frame = samples;
+                f0s.push_back (findF0 (frame, analyser.get(), peaks));
+
+                int advance = std::min (hopSize, numSamples);
+                samples += advance;
+                numSamples -= advance;
+                numToSkip = hopSize - advance;
+            }
+            else
+            {
+                // otherwise build the frame up in the buffer
+                int copy = std::min (frameSize - numBuffered, numSamples);
+                std::copy (samples, samples + copy, buffer.begin() + numBuffered);
+                numBuffered += copy;
+                samples += copy;
+                numSamples -= copy;
+
+                if (numBuffered < frameSize)
+                {
+                    break;
+                }
+
+                f0s.push_back (findF0 (&buffer [0], analyser.get(), peaks));
+
+                // keep the overlap with the next frame
+                if (hopSize < frameSize)
+                {
+                    std::copy (buffer.begin() + hopSize, buffer.end(), buffer.begin());
+                    numBuffered = frameSize - hopSize;
+                }
+                else
+                {
+                    numBuffered = 0;
+                    numToSkip = hopSize - frameSize;
+                }
+            }
+        }
+    }
+
+    void F0Tracker::reset()
+    {
+        numBuffered = 0;
+        numToSkip = 0;
+
+        if (waveletStateOwner == this)
+        {
+            waveletStateOwner = NULL;
+        }
+    }
+
+    double F0Tracker::getSampleRate() const
+    {
+        return sampleRate;
+    }
+
+    int F0Tracker::getFrameSize() const
+    {
+        return frameSize;
+    }
+
+    int F0Tracker::getHopSize() const
+    {
+        return hopSize;
+    }
+
+    F0Tracker::Method F0Tracker::getMethod() const
+    {
+        return method;
+    }
+
+    double F0Tracker::findF0 (const double* frame, SpectrumAnalyser* analyser, double* peaks)
+    {
+        if (method == waveletMethod)
+        {
+            // pick up where we left off unless someone else has used the state
+            if (waveletStateOwner != this)
+            {
+                xtract_init_wavelet_f0_state();
+                waveletStateOwner = this;
+            }
+
+            double f0 = 0;
+            xtract_wavelet_f0 (frame, frameSize, &sampleRate, &f0);
+            return f0;
+        }
+        else
+        {
+            return XtractOctave::findF0 (frame, frameSize, sampleRate, *analyser, peaks);
+        }
+    }
+
+    double findF0 (const double* frame, int frameLength, double sampleRate,
+                   SpectrumAnalyser& analyser, double* peaks)
+    {
+        double f0 = 0;
+        int firstExtractionResult = xtract_f0 (frame, frameLength, &sampleRate, &f0);
+
+        // if xtract_f0 fails we find the lowest spectral peak (a la xtract_failsafe_f0)
+        if (firstExtractionResult == XTRACT_NO_RESULT)
+        {
+            int paddedLength = analyser.getPaddedLength();
+
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            // find spectral peaks
+            double argumentArray [2] = {analyser.getSampleRateByN(), 10};
+            xtract_peak_spectrum (spectrum, paddedLength / 2, argumentArray, peaks);
+
+            // find lowest frequency peak
+            argumentArray [0] = 0;
+            xtract_lowest_value (peaks + (paddedLength / 2), paddedLength / 2, argumentArray, &f0);
+        }
+
+        return f0;
+    }
+
+    void resetWaveletF0State()
+    {
+        xtract_init_wavelet_f0_state();
+        waveletStateOwner = NULL;
+    }
+
+    HandleRegistry<F0Tracker>& getF0Trackers()
+    {
+        return f0Trackers;
+    }
+}
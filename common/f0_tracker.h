@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_F0_TRACKER_H
+#define XTRACT_OCTAVE_F0_TRACKER_H
+
+#include "handles.h"
+#include "spectrum.h"
+#include <vector>
+
+namespace XtractOctave
+{
+    // Tracks the fundamental frequency of a signal which arrives in chunks
+    // of any length.
+    //
+    // The samples which don't yet make up a whole frame are kept between
+    // chunks, so the memory used never grows beyond one frame however long
+    // the signal is. With the wavelet method the pitch tracker's state is
+    // carried from one frame to the next, as the algorithm intends.
+    //
+    // LibXtract keeps the wavelet tracker state in a single global, so only
+    // one tracker can own it at a time. If another tracker (or a call to
+    // xtract_wavelet_f0) has used it since this tracker's last frame, the
+    // state is reinitialised before this tracker carries on.
+    class F0Tracker
+    {
+    public:
+        enum Method
+        {
+            // xtract_wavelet_f0
+            waveletMethod,
+
+            // xtract_f0, falling back on the lowest spectral peak as xtract_f0.oct does
+            spectralMethod
+        };
+
+        F0Tracker (double sampleRate, int frameSize, int hopSize, Method method);
+        ~F0Tracker();
+
+        // feed the next chunk of the signal, the f0 of each frame completed
+        // by it is appended to f0s
+        void process (const double* samples, int numSamples, std::vector<double>& f0s);
+
+        // forget any buffered samples and the wavelet state
+        void reset();
+
+        double getSampleRate() const;
+        int getFrameSize() const;
+        int getHopSize() const;
+        Method getMethod() const;
+
+    private:
+        double findF0 (const double* frame, SpectrumAnalyser* analyser, double* peaks);
+
+        double sampleRate;
+        int frameSize;
+        int hopSize;
+        Method method;
+
+        // the start of the next frame, less than frameSize samples
+        std::vector<double> buffer;
+        int numBuffered;
+
+        // samples still to be skipped when the hop size is longer than a frame
+        int numToSkip;
+    };
+
+    // Find the f0 of a frame as xtract_f0.oct does, using xtract_f0 and
+    // falling back on the lowest spectral peak if it finds nothing. peaks
+    // must have room for analyser.getPaddedLength() values.
+    double findF0 (const double* frame, int frameLength, double sampleRate,
+                   SpectrumAnalyser& analyser, double* peaks);
+
+    // Reinitialise LibXtract's wavelet f0 state, taking it away from any
+    // tracker which was using it.
+    void resetWaveletF0State();
+
+    // the trackers created by xtract_f0_tracker
+    HandleRegistry<F0Tracker>& getF0Trackers();
+}
+
+#endif
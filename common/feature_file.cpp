@@ -0,0 +1,409 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "feature_file.h"
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        const char magic [8] = {'X', 'T', 'R', 'F', 'E', 'A', 'T', 0};
+        const uint32_t version = 1;
+        const uint32_t float64Type = 0;
+        const uint32_t float32Type = 1;
+
+        // the size of the fixed part of the header
+        const size_t fixedHeaderLength = 40;
+
+        // the values start on a cache line
+        const size_t valueAlignment = 64;
+
+        bool isLittleEndianHost()
+        {
+            uint16_t value = 1;
+            unsigned char firstByte;
+            memcpy (&firstByte, &value, 1);
+            return firstByte == 1;
+        }
+
+        void writeLittleEndian (unsigned char* bytes, uint64_t value, int numBytes)
+        {
+            for (int i = 0; i < numBytes; ++i)
+            {
+                bytes [i] = (value >> (8 * i)) & 0xFF;
+            }
+        }
+
+        uint64_t readLittleEndian (const unsigned char* bytes, int numBytes)
+        {
+            uint64_t value = 0;
+
+            for (int i = numBytes - 1; i >= 0; --i)
+            {
+                value = (value << 8) | bytes [i];
+            }
+
+            return value;
+        }
+
+        // store a value, as it would lie in memory on a little endian machine
+        template <typename T>
+        void storeValue (unsigned char* bytes, T value, bool isLittleEndian)
+        {
+            if (isLittleEndian)
+            {
+                memcpy (bytes, &value, sizeof (T));
+                return;
+            }
+
+            typedef typename std::conditional<sizeof (T) == 4, uint32_t, uint64_t>::type Bits;
+            Bits bits;
+            memcpy (&bits, &value, sizeof (T));
+            writeLittleEndian (bytes, bits, sizeof (T));
+        }
+
+        template <typename T>
+        T loadValue (const unsigned char* bytes, bool isLittleEndian)
+        {
+            T value;
+
+            if (isLittleEndian)
+            {
+                memcpy (&value, bytes, sizeof (T));
+                return value;
+            }
+
+            typedef typename std::conditional<sizeof (T) == 4, uint32_t, uint64_t>::type Bits;
+            Bits bits = readLittleEndian (bytes, sizeof (T));
+            memcpy (&value, &bits, sizeof (T));
+            return value;
+        }
+    }
+
+    FeatureFile::FeatureFile()
+      : mapping (MAP_FAILED),
+        mappingLength (0),
+        frameRate (0),
+        numFrames (0),
+        singlePrecision (false)
+    {
+    }
+
+    FeatureFile::~FeatureFile()
+    {
+        if (mapping != MAP_FAILED)
+        {
+            munmap (mapping, mappingLength);
+        }
+    }
+
+    FeatureFile* FeatureFile::create (const std::string& path, const std::vector<std::string>& names,
+                                      const std::vector<int>& lengths, double frameRate, long numFrames,
+                                      bool singlePrecision, std::string& problem)
+    {
+        FeatureFile* file = new FeatureFile();
+        file->names = names;
+        file->lengths = lengths;
+        file->frameRate = frameRate;
+        file->numFrames = numFrames;
+        file->singlePrecision = singlePrecision;
+
+        // lay out the header and the values
+        size_t headerLength = fixedHeaderLength;
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            headerLength += 8 + names [i].size();
+        }
+
+        size_t valueSize = singlePrecision ? sizeof (float) : sizeof (double);
+        size_t offset = (headerLength + valueAlignment - 1) / valueAlignment * valueAlignment;
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            file->offsets.push_back (offset);
+            offset += (size_t) lengths [i] * numFrames * valueSize;
+        }
+
+        // make the file its full length and map it, the values are written
+        // straight into the mapping
+        int descriptor = ::open (path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if (descriptor < 0)
+        {
+            problem = "it can't be created";
+            delete file;
+            return NULL;
+        }
+
+        file->mappingLength = offset;
+
+        if (ftruncate (descriptor, offset) != 0)
+        {
+            problem = "there isn't room for it";
+            close (descriptor);
+            delete file;
+            return NULL;
+        }
+
+        file->mapping = mmap (NULL, offset, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        close (descriptor);
+
+        if (file->mapping == MAP_FAILED)
+        {
+            problem = "it can't be mapped into memory";
+            delete file;
+            return NULL;
+        }
+
+        // write the header
+        unsigned char* bytes = (unsigned char*) file->mapping;
+        uint64_t frameRateBits;
+        memcpy (&frameRateBits, &frameRate, sizeof (double));
+
+        memcpy (bytes, magic, 8);
+        writeLittleEndian (bytes + 8, version, 4);
+        writeLittleEndian (bytes + 12, singlePrecision ? float32Type : float64Type, 4);
+        writeLittleEndian (bytes + 16, frameRateBits, 8);
+        writeLittleEndian (bytes + 24, numFrames, 8);
+        writeLittleEndian (bytes + 32, names.size(), 4);
+        writeLittleEndian (bytes + 36, names.empty() ? offset : file->offsets [0], 4);
+
+        unsigned char* position = bytes + fixedHeaderLength;
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            writeLittleEndian (position, lengths [i], 4);
+            writeLittleEndian (position + 4, names [i].size(), 4);
+            memcpy (position + 8, names [i].data(), names [i].size());
+            position += 8 + names [i].size();
+        }
+
+        return file;
+    }
+
+    FeatureFile* FeatureFile::open (const std::string& path, std::string& problem)
+    {
+        int descriptor = ::open (path.c_str(), O_RDONLY);
+
+        if (descriptor < 0)
+        {
+            problem = "it can't be opened";
+            return NULL;
+        }
+
+        struct stat status;
+
+        if (fstat (descriptor, &status) != 0 || (size_t) status.st_size < fixedHeaderLength)
+        {
+            problem = "it isn't a feature file";
+            close (descriptor);
+            return NULL;
+        }
+
+        FeatureFile* file = new FeatureFile();
+        file->mappingLength = status.st_size;
+        file->mapping = mmap (NULL, file->mappingLength, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close (descriptor);
+
+        if (file->mapping == MAP_FAILED)
+        {
+            problem = "it can't be mapped into memory";
+            delete file;
+            return NULL;
+        }
+
+        const unsigned char* bytes = (const unsigned char*) file->mapping;
+
+        if (memcmp (bytes, magic, 8) != 0 || readLittleEndian (bytes + 8, 4) != version)
+        {
+            problem = "it isn't a feature file this version can read";
+            delete file;
+            return NULL;
+        }
+
+        uint64_t frameRateBits = readLittleEndian (bytes + 16, 8);
+        memcpy (&file->frameRate, &frameRateBits, sizeof (double));
+
+        uint32_t type = readLittleEndian (bytes + 12, 4);
+        file->singlePrecision = (type == float32Type);
+        uint64_t numFrames = readLittleEndian (bytes + 24, 8);
+        size_t numFeatures = readLittleEndian (bytes + 32, 4);
+        size_t headerEnd = readLittleEndian (bytes + 36, 4);
+        size_t valueSize = file->singlePrecision ? sizeof (float) : sizeof (double);
+
+        // the names have to fit between the fixed header and the data, and
+        // the data has to start inside the file
+        bool isValid = (type == float32Type || type == float64Type) &&
+                       numFrames <= (uint64_t) std::numeric_limits<long>::max() &&
+                       headerEnd >= fixedHeaderLength && headerEnd <= file->mappingLength;
+
+        file->numFrames = isValid ? (long) numFrames : 0;
+
+        // read the feature names and lengths, checking nothing runs past
+        // the end of the header or the file
+        size_t position = fixedHeaderLength;
+        size_t dataOffset = headerEnd;
+
+        for (size_t i = 0; i < numFeatures && isValid; ++i)
+        {
+            if (headerEnd - position < 8)
+            {
+                isValid = false;
+                break;
+            }
+
+            int length = (int32_t) readLittleEndian (bytes + position, 4);
+            size_t nameLength = readLittleEndian (bytes + position + 4, 4);
+
+            if (length < 0 || headerEnd - position - 8 < nameLength)
+            {
+                isValid = false;
+                break;
+            }
+
+            // check the feature's values fit in what's left of the file by
+            // dividing, so a huge length or frame count can't overflow
+            size_t remaining = (file->mappingLength - dataOffset) / valueSize;
+
+            if (length > 0 && file->numFrames > 0 &&
+                (size_t) length > remaining / (size_t) file->numFrames)
+            {
+                isValid = false;
+                break;
+            }
+
+            file->names.push_back (std::string ((const char*) bytes + position + 8, nameLength));
+            file->lengths.push_back (length);
+            file->offsets.push_back (dataOffset);
+
+            position += 8 + nameLength;
+            dataOffset += (size_t) length * file->numFrames * valueSize;
+        }
+
+        if (! isValid)
+        {
+            problem = "it is damaged or cut short";
+            delete file;
+            return NULL;
+        }
+
+        return file;
+    }
+
+    void FeatureFile::write (int feature, long firstFrame, long numFramesToWrite, const double* values)
+    {
+        bool isLittleEndian = isLittleEndianHost();
+        size_t numValues = (size_t) lengths [feature] * numFramesToWrite;
+        size_t valueSize = singlePrecision ? sizeof (float) : sizeof (double);
+        unsigned char* destination = (unsigned char*) mapping + offsets [feature]
+                                     + (size_t) lengths [feature] * firstFrame * valueSize;
+
+        if (singlePrecision)
+        {
+            for (size_t i = 0; i < numValues; ++i)
+            {
+                storeValue<float> (destination + i * sizeof (float), values [i], isLittleEndian);
+            }
+        }
+        else if (isLittleEndian)
+        {
+            memcpy (destination, values, numValues * sizeof (double));
+        }
+        else
+        {
+            for (size_t i = 0; i < numValues; ++i)
+            {
+                storeValue<double> (destination + i * sizeof (double), values [i], isLittleEndian);
+            }
+        }
+    }
+
+    template <typename T>
+    void FeatureFile::readValues (int feature, T* values) const
+    {
+        bool isLittleEndian = isLittleEndianHost();
+        size_t numValues = (size_t) lengths [feature] * numFrames;
+        const unsigned char* source = (const unsigned char*) mapping + offsets [feature];
+
+        for (size_t i = 0; i < numValues; ++i)
+        {
+            if (singlePrecision)
+            {
+                values [i] = loadValue<float> (source + i * sizeof (float), isLittleEndian);
+            }
+            else
+            {
+                values [i] = loadValue<double> (source + i * sizeof (double), isLittleEndian);
+            }
+        }
+    }
+
+    void FeatureFile::read (int feature, double* values) const
+    {
+        readValues (feature, values);
+    }
+
+    void FeatureFile::read (int feature, float* values) const
+    {
+        readValues (feature, values);
+    }
+
+    int FeatureFile::getNumFeatures() const
+    {
+        return names.size();
+    }
+
+    const std::string& FeatureFile::getName (int feature) const
+    {
+        return names [feature];
+    }
+
+    int FeatureFile::getLength (int feature) const
+    {
+        return lengths [feature];
+    }
+
+    double FeatureFile::getFrameRate() const
+    {
+        return frameRate;
+    }
+
+    long FeatureFile::getNumFrames() const
+    {
+        return numFrames;
+    }
+
+    bool FeatureFile::isSinglePrecision() const
+    {
+        return singlePrecision;
+    }
+}
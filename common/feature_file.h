@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_FEATURE_FILE_H
+#define XTRACT_OCTAVE_FEATURE_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace XtractOctave
+{
+    // Feature files hold the values of several features for a sequence of
+    // frames, written and read through a memory map so they never need to
+    // pass through the interpreter.
+    //
+    // Everything is little endian. The header is:
+    //
+    //     8 bytes   "XTRFEAT" followed by a zero byte
+    //     uint32    the version of the format, 1
+    //     uint32    the type of the values, 0 for float64 or 1 for float32
+    //     float64   the frame rate in Hz (the sample rate over the hop
+    //               size), 0 if it isn't known
+    //     uint64    the number of frames
+    //     uint32    the number of features
+    //     uint32    the offset of the values from the start of the file
+    //
+    // followed by each feature's number of values per frame (uint32), the
+    // length of its name (uint32) and its name (without a terminating
+    // zero). The values start at the given offset, a multiple of 64 bytes,
+    // with each feature's values in turn stored as a column major matrix of
+    // one column per frame, just as the feature is returned to Octave.
+    class FeatureFile
+    {
+    public:
+        ~FeatureFile();
+
+        // Create a file for the given features (each with the given number
+        // of values per frame), returns NULL with problem saying why if it
+        // can't be created.
+        static FeatureFile* create (const std::string& path, const std::vector<std::string>& names,
+                                    const std::vector<int>& lengths, double frameRate, long numFrames,
+                                    bool singlePrecision, std::string& problem);
+
+        // Open an existing file to read, returns NULL with problem saying
+        // why if it can't be read.
+        static FeatureFile* open (const std::string& path, std::string& problem);
+
+        // write the values of numFrames frames of a feature from firstFrame
+        // on, one column of values per frame
+        void write (int feature, long firstFrame, long numFrames, const double* values);
+
+        int getNumFeatures() const;
+        const std::string& getName (int feature) const;
+        int getLength (int feature) const;
+        double getFrameRate() const;
+        long getNumFrames() const;
+        bool isSinglePrecision() const;
+
+        // copy out all the values of a feature, the float version should
+        // only be used for single precision files
+        void read (int feature, double* values) const;
+        void read (int feature, float* values) const;
+
+    private:
+        FeatureFile();
+
+        template <typename T>
+        void readValues (int feature, T* values) const;
+
+        void* mapping;
+        size_t mappingLength;
+        std::vector<std::string> names;
+        std::vector<int> lengths;
+        std::vector<size_t> offsets;
+        double frameRate;
+        long numFrames;
+        bool singlePrecision;
+    };
+}
+
+#endif
@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "features.h"
+#include "feature_file.h"
+#include "peaks.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <memory>
+#include <cmath>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        void extractSpectralCentroid (FrameAnalysis& analysis, double* result)
+        {
+            xtract_spectral_centroid (analysis.getSpectrum(), analysis.getPaddedLength(), NULL, result);
+        }
+
+        void extractSpread (FrameAnalysis& analysis, double* result)
+        {
+            double spectralCentroid = 0;
+            extractSpectralCentroid (analysis, &spectralCentroid);
+            xtract_spread (analysis.getSpectrum(), analysis.getPaddedLength() / 2, &spectralCentroid, result);
+        }
+
+        void extractSpectralVariance (FrameAnalysis& analysis, double* result)
+        {
+            *result = analysis.getSpectralVariance();
+        }
+
+        void extractSpectralStandardDeviation (FrameAnalysis& analysis, double* result)
+        {
+            *result = sqrt (analysis.getSpectralVariance());
+        }
+
+        void extractSpectralSkewness (FrameAnalysis& analysis, double* result)
+        {
+            double spectralMeanAndDeviation [2] = {analysis.getSpectralMean(), sqrt (analysis.getSpectralVariance())};
+            xtract_spectral_skewness (analysis.getSpectrum(), analysis.getPaddedLength(), spectralMeanAndDeviation, result);
+        }
+
+        void extractSpectralKurtosis (FrameAnalysis& analysis, double* result)
+        {
+            double spectralMeanAndDeviation [2] = {analysis.getSpectralMean(), sqrt (analysis.getSpectralVariance())};
+            xtract_spectral_kurtosis (analysis.getSpectrum(), analysis.getPaddedLength(), spectralMeanAndDeviation, result);
+        }
+
+        void extractFlatness (FrameAnalysis& analysis, double* result)
+        {
+            xtract_flatness (analysis.getSpectrum(), analysis.getPaddedLength() / 2, NULL, result);
+        }
+
+        void extractTonality (FrameAnalysis& analysis, double* result)
+        {
+            double spectralFlatness = 0;
+            extractFlatness (analysis, &spectralFlatness);
+
+            double spectralFlatnessDB = 0;
+            xtract_flatness_db (NULL, 0, &spectralFlatness, &spectralFlatnessDB);
+
+            xtract_tonality (NULL, 0, &spectralFlatnessDB, result);
+        }
+
+        void extractRolloff (FrameAnalysis& analysis, double* result)
+        {
+            double argumentArray [2] = {analysis.getSampleRateByN(), analysis.getRolloffThreshold()};
+            xtract_rolloff (analysis.getSpectrum(), analysis.getPaddedLength() / 2, argumentArray, result);
+        }
+
+        void extractSpectralSlope (FrameAnalysis& analysis, double* result)
+        {
+            xtract_spectral_slope (analysis.getSpectrum(), analysis.getPaddedLength() / 2, NULL, result);
+        }
+
+        void extractPower (FrameAnalysis& analysis, double* result)
+        {
+            xtract_power (analysis.getSpectrum(), analysis.getPaddedLength() / 2, NULL, result);
+        }
+
+        void extractCrest (FrameAnalysis& analysis, double* result)
+        {
+            double magnitudeMax = 0;
+            xtract_highest_value (analysis.getSpectrum(), analysis.getPaddedLength() / 2, NULL, &magnitudeMax);
+
+            double magnitudeMean = 0;
+            xtract_mean (analysis.getSpectrum(), analysis.getPaddedLength() / 2, NULL, &magnitudeMean);
+
+            double argumentArray [2] = {magnitudeMax, magnitudeMean};
+            xtract_crest (NULL, 0, argumentArray, result);
+        }
+
+        void extractSmoothness (FrameAnalysis& analysis, double* result)
+        {
+            xtract_smoothness (analysis.getSpectrum(), analysis.getPaddedLength() / 2, NULL, result);
+        }
+
+        void extractSharpness (FrameAnalysis& analysis, double* result)
+        {
+            xtract_sharpness (analysis.getBarkCoefficients(), XTRACT_BARK_BANDS - 1, NULL, result);
+        }
+
+        void extractIrregularityK (FrameAnalysis& analysis, double* result)
+        {
+            xtract_irregularity_k (analysis.getSpectrum(), analysis.getPaddedLength() / 2, NULL, result);
+        }
+
+        void extractIrregularityJ (FrameAnalysis& analysis, double* result)
+        {
+            xtract_irregularity_j (analysis.getSpectrum(), analysis.getPaddedLength() / 2, NULL, result);
+        }
+
+        void extractLoudness (FrameAnalysis& analysis, double* result)
+        {
+            xtract_loudness (analysis.getBarkCoefficients(), XTRACT_BARK_BANDS - 1, NULL, result);
+        }
+
+        void extractBarkCoefficients (FrameAnalysis& analysis, double* result)
+        {
+            const double* barkCoefficients = analysis.getBarkCoefficients();
+            std::copy (barkCoefficients, barkCoefficients + XTRACT_BARK_BANDS - 1, result);
+        }
+
+        void extractHps (FrameAnalysis& analysis, double* result)
+        {
+            double sampleRate = analysis.getSampleRate();
+            xtract_hps (analysis.getSpectrum(), analysis.getPaddedLength(), &sampleRate, result);
+        }
+
+        void extractMfcc (FrameAnalysis& analysis, double* result)
+        {
+            xtract_mfcc (analysis.getSpectrum(), analysis.getPaddedLength() / 2, analysis.getMelFilters(), result);
+        }
+
+        void extractNoisiness (FrameAnalysis& analysis, double* result)
+        {
+            const double* peaks = analysis.getPeaks();
+            const double* harmonics = analysis.getHarmonics();
+
+            // find number of partials and harmonics
+            int numPartials = 0;
+            int numHarmonics = 0;
+            int n = analysis.getPeakSpectrumLength() / 2;
+            while (n--)
+            {
+                if (peaks [n] > 0)
+                {
+                    ++numPartials;
+                }
+
+                if (harmonics [n] > 0)
+                {
+                    ++numHarmonics;
+                }
+            }
+
+            double argumentArray [2] = {(double) numHarmonics, (double) numPartials};
+            xtract_noisiness (NULL, 0, argumentArray, result);
+        }
+
+        void extractOddEvenRatio (FrameAnalysis& analysis, double* result)
+        {
+            double f0 = analysis.getF0();
+
+            if (analysis.hasSparsePeaks())
+            {
+                *result = findOddEvenRatio (analysis.getHarmonics(), analysis.getPeakSpectrumLength() / 2, f0);
+            }
+            else
+            {
+                xtract_odd_even_ratio (analysis.getHarmonics(), analysis.getPaddedLength(), &f0, result);
+            }
+        }
+
+        void extractTristimulus1 (FrameAnalysis& analysis, double* result)
+        {
+            xtract_tristimulus_1 (analysis.getPartials(), analysis.getPeakSpectrumLength() / 2, NULL, result);
+        }
+
+        void extractTristimulus2 (FrameAnalysis& analysis, double* result)
+        {
+            xtract_tristimulus_2 (analysis.getPartials(), analysis.getPeakSpectrumLength() / 2, NULL, result);
+        }
+
+        void extractTristimulus3 (FrameAnalysis& analysis, double* result)
+        {
+            xtract_tristimulus_3 (analysis.getPartials(), analysis.getPeakSpectrumLength() / 2, NULL, result);
+        }
+
+        void extractTristimulus (FrameAnalysis& analysis, double* result)
+        {
+            extractTristimulus1 (analysis, result);
+            extractTristimulus2 (analysis, result + 1);
+            extractTristimulus3 (analysis, result + 2);
+        }
+
+        void extractSpectralInharmonicity (FrameAnalysis& analysis, double* result)
+        {
+            double f0 = analysis.getF0();
+            xtract_spectral_inharmonicity (analysis.getPeaks(), analysis.getPeakSpectrumLength(), &f0, result);
+        }
+
+        void extractZcr (FrameAnalysis& analysis, double* result)
+        {
+            xtract_zcr (analysis.getFrame(), analysis.getInputLength(), NULL, result);
+        }
+
+        const Feature features [] =
+        {
+            {"spectral_centroid", 1, false, false, extractSpectralCentroid},
+            {"spread", 1, false, false, extractSpread},
+            {"spectral_variance", 1, false, false, extractSpectralVariance},
+            {"spectral_standard_deviation", 1, false, false, extractSpectralStandardDeviation},
+            {"spectral_skewness", 1, false, false, extractSpectralSkewness},
+            {"spectral_kurtosis", 1, false, false, extractSpectralKurtosis},
+            {"flatness", 1, false, false, extractFlatness},
+            {"tonality", 1, false, false, extractTonality},
+            {"rolloff", 1, false, false, extractRolloff},
+            {"spectral_slope", 1, false, false, extractSpectralSlope},
+            {"power", 1, false, false, extractPower},
+            {"crest", 1, false, false, extractCrest},
+            {"smoothness", 1, false, false, extractSmoothness},
+            {"sharpness", 1, false, false, extractSharpness},
+            {"irregularity_k", 1, false, false, extractIrregularityK},
+            {"irregularity_j", 1, false, false, extractIrregularityJ},
+            {"loudness", 1, false, false, extractLoudness},
+            {"bark_coefficients", XTRACT_BARK_BANDS - 1, false, false, extractBarkCoefficients},
+            {"hps", 1, false, false, extractHps},
+            {"mfcc", 13, false, false, extractMfcc},
+            {"noisiness", 1, true, false, extractNoisiness},
+            {"odd_even_ratio", 1, true, false, extractOddEvenRatio},
+            {"tristimulus_1", 1, false, false, extractTristimulus1},
+            {"tristimulus_2", 1, false, false, extractTristimulus2},
+            {"tristimulus_3", 1, false, false, extractTristimulus3},
+            {"tristimulus", 3, false, false, extractTristimulus},
+            {"spectral_inharmonicity", 1, true, false, extractSpectralInharmonicity},
+            {"zcr", 1, false, true, extractZcr}
+        };
+
+        const int numFeatures = sizeof (features) / sizeof (features [0]);
+    }
+
+    const Feature* findFeature (const std::string& name)
+    {
+        for (int i = 0; i < numFeatures; ++i)
+        {
+            if (name == features [i].name)
+            {
+                return &features [i];
+            }
+        }
+
+        return NULL;
+    }
+
+    std::vector<std::string> getFeatureNames()
+    {
+        std::vector<std::string> names;
+
+        for (int i = 0; i < numFeatures; ++i)
+        {
+            names.push_back (features [i].name);
+        }
+
+        return names;
+    }
+
+    std::vector<Matrix> extractFeatures (const Frames& frames, double sampleRate, const Options& options,
+                                         const std::vector<const Feature*>& features,
+                                         const FrameParameter& f0, double harmonicThreshold,
+                                         FeatureFile* output)
+    {
+        int numFrames = frames.getNumFrames();
+
+        // set up the shared analysis, one per thread if the frames are to be
+        // shared between threads
+        int numThreads = std::max (1, std::min (options.numThreads, numFrames));
+        std::vector<std::unique_ptr<FrameAnalysis> > analyses;
+
+        for (int thread = 0; thread < numThreads; ++thread)
+        {
+            analyses.push_back (std::unique_ptr<FrameAnalysis> (
+                new FrameAnalysis (frames.getFrameLength(), sampleRate, frames.getWindow(),
+                                   numThreads > 1, thread, frames.getFFTLength(),
+                                   options.singlePrecision)));
+            analyses [thread]->setInputIsSpectrum (frames.isSpectrum());
+            analyses [thread]->setHarmonicThreshold (harmonicThreshold);
+            analyses [thread]->setPeakPicking (options.peakThreshold, options.maxPeaks);
+        }
+
+        // work through the frames a block at a time so an interrupt is
+        // noticed between blocks
+        int blockLength = numThreads > 1 ? numThreads * 16 : 1;
+
+        // assign memory for the results, one column per frame for each
+        // feature, or for a single block if they are going to a file
+        int numFeatures = features.size();
+        int numResultFrames = output ? std::min (blockLength, numFrames) : numFrames;
+        std::vector<Matrix> results;
+        std::vector<double*> resultData;
+
+        for (int i = 0; i < numFeatures; ++i)
+        {
+            results.push_back (Matrix (features [i]->length, numResultFrames));
+        }
+
+        for (int i = 0; i < numFeatures; ++i)
+        {
+            resultData.push_back (results [i].fortran_vec());
+        }
+
+        // each thread gets a contiguous run of frames in the block and
+        // writes straight into their columns
+        for (int blockStart = 0; blockStart < numFrames; blockStart += blockLength)
+        {
+            OCTAVE_QUIT;
+
+            int numBlockFrames = std::min (blockLength, numFrames - blockStart);
+            int resultStart = output ? blockStart : 0;
+
+            parallelFor (numBlockFrames, numThreads, [&] (int first, int last, int thread)
+            {
+                FrameAnalysis& analysis = *analyses [thread];
+
+                for (int frame = blockStart + first; frame < blockStart + last; ++frame)
+                {
+                    // single precision frames are read as they are
+                    if (frames.isSingle())
+                    {
+                        analysis.setFrame (frames.getSingleFrame (frame), f0 [frame]);
+                    }
+                    else
+                    {
+                        analysis.setFrame (frames.getFrame (frame), f0 [frame]);
+                    }
+
+                    for (int i = 0; i < numFeatures; ++i)
+                    {
+                        int length = features [i]->length;
+                        features [i]->extract (analysis, resultData [i] + (frame - resultStart) * length);
+                    }
+                }
+            });
+
+            if (output)
+            {
+                for (int i = 0; i < numFeatures; ++i)
+                {
+                    output->write (i, blockStart, numBlockFrames, resultData [i]);
+                }
+            }
+        }
+
+        if (output)
+        {
+            return std::vector<Matrix>();
+        }
+
+        return results;
+    }
+}
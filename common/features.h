@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_FEATURES_H
+#define XTRACT_OCTAVE_FEATURES_H
+
+#include "analysis.h"
+#include "frames.h"
+#include "options.h"
+#include <string>
+#include <vector>
+
+namespace XtractOctave
+{
+    class FeatureFile;
+
+    // A feature which can be found from the intermediate results held by a
+    // FrameAnalysis. Each one is calculated in exactly the same way as the
+    // wrapper function of the same name (without the xtract_ prefix).
+    struct Feature
+    {
+        const char* name;
+
+        // the number of values the feature has for each frame
+        int length;
+
+        // true if the feature can't be found without the fundamental frequency
+        bool needsF0;
+
+        // true if the feature is found from the signal rather than its
+        // spectrum, so can't be found when given a spectrum
+        bool needsSignal;
+
+        void (*extract) (FrameAnalysis& analysis, double* result);
+    };
+
+    // Look up a feature by name, returns NULL if there isn't one.
+    const Feature* findFeature (const std::string& name);
+
+    // The names of all the features findFeature knows about.
+    std::vector<std::string> getFeatureNames();
+
+    // Find the given features of every frame in one pass, each frame's
+    // intermediate results are found once and shared between the features
+    // and the frames are shared between options.numThreads threads. Returns
+    // a matrix for each feature with one column per frame, unless output
+    // is given, in which case each block of frames is written to it as soon
+    // as it is found and nothing is returned.
+    std::vector<Matrix> extractFeatures (const Frames& frames, double sampleRate, const Options& options,
+                                         const std::vector<const Feature*>& features,
+                                         const FrameParameter& f0, double harmonicThreshold = 0.2,
+                                         FeatureFile* output = NULL);
+}
+
+#endif
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "fft.h"
+#include <algorithm>
+#include <cmath>
+
+namespace XtractOctave
+{
+    template <typename T>
+    BasicRealFFT<T>::BasicRealFFT (int length)
+      : N (length),
+        halfN (length / 2),
+        isPowerOfTwo (halfN > 0 && (halfN & (halfN - 1)) == 0),
+        realTwiddles (halfN + 1),
+        buffer (halfN),
+        bins (halfN + 1)
+    {
+        for (int k = 0; k <= halfN; ++k)
+        {
+            realTwiddles [k] = std::complex<T> (std::polar (1.0, -2 * M_PI * k / N));
+        }
+
+        // the real input is packed into a complex fft half as long
+        if (! isPowerOfTwo)
+        {
+            int remaining = halfN;
+            int largestRadix = 1;
+
+            for (int radix = 2; remaining > 1; ++radix)
+            {
+                while (remaining % radix == 0)
+                {
+                    remaining /= radix;
+                    stages.push_back (radix);
+                    stages.push_back (remaining);
+                    largestRadix = radix;
+                }
+            }
+
+            twiddles.resize (halfN);
+
+            for (int k = 0; k < halfN; ++k)
+            {
+                twiddles [k] = std::complex<T> (std::polar (1.0, -2 * M_PI * k / halfN));
+            }
+
+            packed.resize (halfN);
+            butterfly.resize (largestRadix);
+            return;
+        }
+
+        bitReversed.resize (halfN);
+        twiddles.resize (halfN / 2 + 1);
+
+        int numBits = 0;
+        while ((1 << numBits) < halfN)
+        {
+            ++numBits;
+        }
+
+        for (int i = 0; i < halfN; ++i)
+        {
+            int reversed = 0;
+            for (int bit = 0; bit < numBits; ++bit)
+            {
+                if (i & (1 << bit))
+                {
+                    reversed |= 1 << (numBits - 1 - bit);
+                }
+            }
+
+            bitReversed [i] = reversed;
+        }
+
+        for (int k = 0; k < (int) twiddles.size(); ++k)
+        {
+            twiddles [k] = std::complex<T> (std::polar (1.0, -2 * M_PI * k / halfN));
+        }
+    }
+
+    template <typename T>
+    int BasicRealFFT<T>::getLength() const
+    {
+        return N;
+    }
+
+    template <typename T>
+    void BasicRealFFT<T>::transform (const T* input, std::complex<T>* output)
+    {
+        if (N == 1)
+        {
+            output [0] = input [0];
+            return;
+        }
+
+        if (isPowerOfTwo)
+        {
+            // pack even samples into the real parts and odd into the imaginary
+            for (int i = 0; i < halfN; ++i)
+            {
+                buffer [bitReversed [i]] = std::complex<T> (input [2 * i], input [2 * i + 1]);
+            }
+
+            // iterative radix 2 butterflies
+            for (int size = 2; size <= halfN; size *= 2)
+            {
+                int half = size / 2;
+                int step = halfN / size;
+
+                for (int start = 0; start < halfN; start += size)
+                {
+                    for (int k = 0; k < half; ++k)
+                    {
+                        std::complex<T> odd = buffer [start + k + half] * twiddles [k * step];
+                        buffer [start + k + half] = buffer [start + k] - odd;
+                        buffer [start + k] += odd;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (int i = 0; i < halfN; ++i)
+            {
+                packed [i] = std::complex<T> (input [2 * i], input [2 * i + 1]);
+            }
+
+            mixedRadix (&buffer [0], &packed [0], 1, 0);
+        }
+
+        // untangle the spectra of the even and odd samples
+        for (int k = 0; k <= halfN; ++k)
+        {
+            std::complex<T> z = buffer [k % halfN];
+            std::complex<T> zMirror = std::conj (buffer [(halfN - k) % halfN]);
+
+            std::complex<T> even = (z + zMirror) * T (0.5);
+            std::complex<T> odd = (z - zMirror) * std::complex<T> (0, T (-0.5));
+
+            output [k] = even + realTwiddles [k] * odd;
+        }
+    }
+
+    template <typename T>
+    void BasicRealFFT<T>::mixedRadix (std::complex<T>* output, const std::complex<T>* input, int stride, int stage)
+    {
+        int radix = stages [stage];
+        int length = stages [stage + 1];
+
+        // transform each of the radix interleaved sub sequences into
+        // consecutive blocks of the output
+        if (length == 1)
+        {
+            for (int j = 0; j < radix; ++j)
+            {
+                output [j] = input [j * stride];
+            }
+        }
+        else
+        {
+            for (int j = 0; j < radix; ++j)
+            {
+                mixedRadix (output + j * length, input + j * stride, stride * radix, stage + 2);
+            }
+        }
+
+        // then combine them
+        if (radix == 2)
+        {
+            for (int k = 0; k < length; ++k)
+            {
+                std::complex<T> odd = output [k + length] * twiddles [k * stride];
+                output [k + length] = output [k] - odd;
+                output [k] += odd;
+            }
+
+            return;
+        }
+
+        for (int u = 0; u < length; ++u)
+        {
+            for (int q = 0; q < radix; ++q)
+            {
+                butterfly [q] = output [u + q * length];
+            }
+
+            for (int q = 0; q < radix; ++q)
+            {
+                int k = u + q * length;
+                int step = ((long) stride * k) % halfN;
+                int twiddle = 0;
+                std::complex<T> sum = butterfly [0];
+
+                for (int r = 1; r < radix; ++r)
+                {
+                    twiddle += step;
+
+                    if (twiddle >= halfN)
+                    {
+                        twiddle -= halfN;
+                    }
+
+                    sum += butterfly [r] * twiddles [twiddle];
+                }
+
+                output [k] = sum;
+            }
+        }
+    }
+
+    template <typename T>
+    void BasicRealFFT<T>::magnitudeSpectrum (const T* input, double sampleRateByN, double* result)
+    {
+        transform (input, &bins [0]);
+
+        // xtract_spectrum falls back on a 44100 Hz sample rate if it isn't given one
+        if (sampleRateByN == 0)
+        {
+            sampleRateByN = 44100.0 / N;
+        }
+
+        for (int m = 0; m < halfN; ++m)
+        {
+            int n = m + 1;
+            result [m] = std::abs (bins [n]) / N;
+            result [halfN + m] = n * sampleRateByN;
+        }
+    }
+
+    template class BasicRealFFT<double>;
+    template class BasicRealFFT<float>;
+
+    int findFFTLength (int inputLength, const std::string& sizing)
+    {
+        inputLength = std::max (inputLength, 1);
+
+        if (sizing == "pow2")
+        {
+            return pow (2, ceil (log2 (inputLength)));
+        }
+        else if (sizing == "exact")
+        {
+            return inputLength + inputLength % 2;
+        }
+        else if (sizing == "fast")
+        {
+            for (int length = inputLength + inputLength % 2; ; length += 2)
+            {
+                int remaining = length;
+
+                while (remaining % 2 == 0) remaining /= 2;
+                while (remaining % 3 == 0) remaining /= 3;
+                while (remaining % 5 == 0) remaining /= 5;
+
+                if (remaining == 1)
+                {
+                    return length;
+                }
+            }
+        }
+
+        return 0;
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_FFT_H
+#define XTRACT_OCTAVE_FFT_H
+
+#include <complex>
+#include <string>
+#include <vector>
+
+namespace XtractOctave
+{
+    // A real to complex fft with its own plan.
+    //
+    // LibXtract keeps a single fft plan in global state, which can't be
+    // shared between threads, and may only handle powers of 2. Each RealFFT
+    // owns its twiddle factors and working memory, so one can be used per
+    // thread. N must be even. Powers of 2 use an iterative radix 2 fft,
+    // other lengths a recursive mixed radix one which is quickest when N / 2
+    // only has small prime factors (see findFFTLength).
+    //
+    // The samples and arithmetic are either double or single precision, the
+    // magnitude spectrum is always returned as doubles for LibXtract.
+    template <typename T>
+    class BasicRealFFT
+    {
+    public:
+        BasicRealFFT (int N);
+
+        int getLength() const;
+
+        // find the first N / 2 + 1 bins of the fft of N real samples
+        void transform (const T* input, std::complex<T>* output);
+
+        // find the magnitude spectrum of N real samples, laid out as
+        // xtract_spectrum lays out an XTRACT_MAGNITUDE_SPECTRUM without the
+        // DC component: N / 2 magnitudes followed by their frequencies
+        void magnitudeSpectrum (const T* input, double sampleRateByN, double* result);
+
+    private:
+        void mixedRadix (std::complex<T>* output, const std::complex<T>* input, int stride, int stage);
+
+        int N;
+        int halfN;
+        bool isPowerOfTwo;
+        std::vector<int> bitReversed;
+        std::vector<std::complex<T> > twiddles;
+
+        // each stage of the mixed radix fft as its radix followed by the
+        // length of the sub transforms it combines
+        std::vector<int> stages;
+        std::vector<std::complex<T> > packed;
+        std::vector<std::complex<T> > butterfly;
+
+        std::vector<std::complex<T> > realTwiddles;
+        std::vector<std::complex<T> > buffer;
+        std::vector<std::complex<T> > bins;
+    };
+
+    typedef BasicRealFFT<double> RealFFT;
+    typedef BasicRealFFT<float> FloatRealFFT;
+
+    // The length of fft to pad a frame of inputLength samples to.
+    //
+    // "pow2" rounds up to a power of 2, which LibXtract's own fft needs.
+    // "exact" uses the frame length itself (rounded up to an even number),
+    // and "fast" the next even length whose only prime factors are 2, 3 and
+    // 5, which is never more than a few percent longer than the frame.
+    // Returns 0 if the sizing isn't recognised.
+    int findFFTLength (int inputLength, const std::string& sizing);
+}
+
+#endif
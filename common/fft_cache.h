@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_FFT_CACHE_H
+#define XTRACT_OCTAVE_FFT_CACHE_H
+
+namespace XtractOctave
+{
+    // Make sure LibXtract has an fft of length N planned for xtract_spectrum.
+    //
+    // LibXtract keeps its spectrum plan in global state, so every .oct file
+    // links against the shared libxtractoctave library which remembers the
+    // length that was last planned. Repeated calls with the same length then
+    // skip the planning stage entirely.
+    void initialiseFFT (int N);
+
+    // Free the fft plan held by LibXtract and forget the planned length.
+    void clearFFTCache();
+
+    // The length of the currently planned fft, or 0 if there isn't one.
+    int plannedFFTLength();
+}
+
+#endif
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "frames.h"
+#include "fft.h"
+#include "spectral_stream.h"
+#include "window.h"
+#include <algorithm>
+
+namespace XtractOctave
+{
+    Frames::Frames (const octave_value& dataToUse, const Options& options)
+      : single (dataToUse.is_single_type()),
+        numFrames (0),
+        frameLength (0),
+        hopSize (1),
+        spectrum (false),
+        fftLength (0),
+        window (NULL)
+    {
+        // each error returns straight away, as parseOptions does, so
+        // nothing more is read from a bad argument
+
+        // a stream's spectra are used as they are, in place of the data
+        if (options.stream != 0)
+        {
+            if (! dataToUse.isempty())
+            {
+                error ("the data must be empty when the spectra come from a stream");
+                return;
+            }
+
+            const SpectralStream* stream = getSpectralStreams().get (options.stream);
+
+            single = false;
+            data = stream->getSpectra();
+            frameLength = stream->getPaddedLength();
+            numFrames = data.columns();
+            hopSize = frameLength;
+            spectrum = true;
+            fftLength = frameLength;
+            return;
+        }
+
+        // the arrays share their storage with the argument, so the frames
+        // are read from the caller's data whatever its shape, single
+        // precision data is kept as it is so the spectra can be found from
+        // it directly
+        if (single)
+        {
+            singleData = dataToUse.float_array_value();
+        }
+        else
+        {
+            data = dataToUse.array_value();
+        }
+
+        dim_vector dims = dataToUse.dims();
+        int numSamples = dims.numel();
+
+        // a vector may lie along any dimension, so long as it is the only
+        // one longer than a single element
+        int numLongDimensions = 0;
+
+        for (int i = 0; i < dims.ndims(); ++i)
+        {
+            if (dims (i) != 1)
+            {
+                ++numLongDimensions;
+            }
+        }
+
+        bool isVector = (numLongDimensions <= 1);
+
+        // otherwise the columns are the frames, any dimensions beyond the
+        // second just give more columns as they follow on in memory
+        int numRows = dims (0);
+        int numColumns = (numRows == 0) ? 0 : numSamples / numRows;
+
+        if (options.frameSize > 0)
+        {
+            if (! isVector)
+            {
+                error ("framesize can only be used when the data is a vector");
+                return;
+            }
+
+            frameLength = options.frameSize;
+            hopSize = options.hopSize;
+
+            if (numSamples < frameLength)
+            {
+                numFrames = 0;
+            }
+            else
+            {
+                numFrames = 1 + (numSamples - frameLength) / hopSize;
+            }
+        }
+        else if (isVector)
+        {
+            numFrames = 1;
+            frameLength = numSamples;
+            hopSize = frameLength;
+        }
+        else
+        {
+            numFrames = numColumns;
+            frameLength = numRows;
+            hopSize = frameLength;
+        }
+
+        fftLength = findFFTLength (std::max (frameLength, 1), options.fftSize);
+
+        if (fftLength == 0)
+        {
+            error ("unknown fftsize \"%s\"", options.fftSize.c_str());
+            return;
+        }
+
+        if (options.input == "spectrum")
+        {
+            // a spectrum is passed straight through, so it is its own fft length
+            if (frameLength % 2 != 0)
+            {
+                error ("a spectrum must have an even length, magnitudes followed by frequencies");
+                return;
+            }
+
+            spectrum = true;
+            fftLength = frameLength;
+        }
+        else if (options.input == "signal")
+        {
+            spectrum = false;
+        }
+        else
+        {
+            error ("input must be either \"signal\" or \"spectrum\"");
+            return;
+        }
+
+        // the window table is shared with every other call using it
+        if (! findWindow (options.window, options.windowParameter, frameLength, window))
+        {
+            error ("unknown window \"%s\"", options.window.c_str());
+            return;
+        }
+    }
+
+    int Frames::getNumFrames() const
+    {
+        return numFrames;
+    }
+
+    int Frames::getFrameLength() const
+    {
+        return frameLength;
+    }
+
+    const double* Frames::getFrame (int frame) const
+    {
+        // everything apart from the spectra works in double precision, so
+        // single data is converted the first time it is needed this way
+        if (single)
+        {
+            std::call_once (dataConverted, [this] ()
+            {
+                widenedData.assign (singleData.data(), singleData.data() + singleData.numel());
+            });
+
+            return widenedData.data() + frame * hopSize;
+        }
+
+        return data.data() + frame * hopSize;
+    }
+
+    bool Frames::isSpectrum() const
+    {
+        return spectrum;
+    }
+
+    int Frames::getFFTLength() const
+    {
+        return fftLength;
+    }
+
+    bool Frames::isSingle() const
+    {
+        return single;
+    }
+
+    const float* Frames::getSingleFrame (int frame) const
+    {
+        return singleData.data() + frame * hopSize;
+    }
+
+    const double* Frames::getWindow() const
+    {
+        return window;
+    }
+
+    FrameParameter::FrameParameter (const octave_value& value, int numFrames)
+      : values (value.array_value()),
+        perFrame (values.numel() != 1),
+        valid (values.numel() == 1 || values.numel() == numFrames)
+    {
+    }
+
+    bool FrameParameter::isValid() const
+    {
+        return valid;
+    }
+
+    double FrameParameter::operator[] (int frame) const
+    {
+        return perFrame ? values (frame) : values (0);
+    }
+
+    octave_value packResults (const Matrix& results)
+    {
+        if (results.columns() == 1)
+        {
+            return octave_value (results.transpose());
+        }
+        else
+        {
+            return octave_value (results);
+        }
+    }
+}
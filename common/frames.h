@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_FRAMES_H
+#define XTRACT_OCTAVE_FRAMES_H
+
+#include <octave/oct.h>
+#include "options.h"
+#include <mutex>
+#include <vector>
+
+namespace XtractOctave
+{
+    // A set of equal length frames of audio taken from an Octave argument.
+    //
+    // A vector (of any orientation) is treated as a single frame. A matrix
+    // is treated as a batch of frames, one per column, with the columns of
+    // any higher dimensional array following on from each other. If a frame
+    // size is given in the options a vector is instead split into frames
+    // hopSize samples apart, any samples left over at the end which don't
+    // fill a whole frame are ignored. In every case the frames point
+    // straight into the argument's data, nothing is copied.
+    class Frames
+    {
+    public:
+        Frames (const octave_value& data, const Options& options = Options());
+
+        int getNumFrames() const;
+        int getFrameLength() const;
+
+        // a pointer to the first sample of the given frame, single precision
+        // data is converted to double the first time this is called (in
+        // plain memory, so it is safe from any thread)
+        const double* getFrame (int frame) const;
+
+        // true if the data is single precision, its frames can then be read
+        // without any conversion through getSingleFrame
+        bool isSingle() const;
+        const float* getSingleFrame (int frame) const;
+
+        // true if the frames are spectra rather than signals (the "input"
+        // option), each one is then getFrameLength() long with the
+        // magnitudes in the first half and the frequencies in the second
+        bool isSpectrum() const;
+
+        // the length of fft to pad each frame to, or for spectra the length
+        // of fft they came from
+        int getFFTLength() const;
+
+        // the window to apply to each frame before finding its spectrum, or
+        // NULL for a rectangular window
+        const double* getWindow() const;
+
+    private:
+        bool single;
+        FloatNDArray singleData;
+        NDArray data;
+        mutable std::vector<double> widenedData;
+        mutable std::once_flag dataConverted;
+        int numFrames;
+        int frameLength;
+        int hopSize;
+        bool spectrum;
+        int fftLength;
+        const double* window;
+    };
+
+    // A parameter which can either be given once for every frame or as a
+    // vector with one element per frame.
+    class FrameParameter
+    {
+    public:
+        FrameParameter (const octave_value& value, int numFrames);
+
+        // false if the value was neither a scalar nor one element per frame
+        bool isValid() const;
+
+        double operator[] (int frame) const;
+
+    private:
+        NDArray values;
+        bool perFrame;
+        bool valid;
+    };
+
+    // Package up a matrix of vector results (one column per frame) for
+    // returning to Octave. A single frame is returned as a row vector as it
+    // always has been, a batch is returned as it is.
+    octave_value packResults (const Matrix& results);
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_HANDLES_H
+#define XTRACT_OCTAVE_HANDLES_H
+
+#include <map>
+#include <memory>
+
+namespace XtractOctave
+{
+    // Objects which live between calls and are referred to from Octave by an
+    // integer handle.
+    //
+    // Each registry lives in the shared library, so a handle returned by one
+    // .oct file can be passed to another. Handles start at 1 and are never
+    // reused within a session.
+    template <typename T>
+    class HandleRegistry
+    {
+    public:
+        HandleRegistry() : nextHandle (1) {}
+
+        // take ownership of an object and return its handle
+        int add (T* object)
+        {
+            int handle = nextHandle++;
+            objects [handle].reset (object);
+            return handle;
+        }
+
+        // the object with the given handle, or NULL if there isn't one
+        T* get (int handle) const
+        {
+            typename std::map<int, std::unique_ptr<T> >::const_iterator found = objects.find (handle);
+            return (found == objects.end()) ? NULL : found->second.get();
+        }
+
+        // delete the object with the given handle, returns false if there isn't one
+        bool remove (int handle)
+        {
+            return objects.erase (handle) > 0;
+        }
+
+    private:
+        std::map<int, std::unique_ptr<T> > objects;
+        int nextHandle;
+    };
+}
+
+#endif
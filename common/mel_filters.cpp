@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "mel_filters.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        struct MelFilterKey
+        {
+            int paddedLength;
+            double sampleRate;
+            int numFilters;
+            double minFrequency;
+            double maxFrequency;
+            int style;
+
+            bool operator< (const MelFilterKey& other) const
+            {
+                if (paddedLength != other.paddedLength) return paddedLength < other.paddedLength;
+                if (sampleRate != other.sampleRate) return sampleRate < other.sampleRate;
+                if (numFilters != other.numFilters) return numFilters < other.numFilters;
+                if (minFrequency != other.minFrequency) return minFrequency < other.minFrequency;
+                if (maxFrequency != other.maxFrequency) return maxFrequency < other.maxFrequency;
+                return style < other.style;
+            }
+        };
+
+        struct MelFilterBank
+        {
+            std::vector<double> storage;
+            std::vector<double*> filterArrays;
+            xtract_mel_filter filters;
+        };
+
+        std::map<MelFilterKey, MelFilterBank> melFilterCache;
+
+        // the cache is shared between the threads of a batch
+        std::mutex melFilterCacheMutex;
+    }
+
+    xtract_mel_filter* getMelFilters (int paddedLength, double sampleRate, int numFilters,
+                                      double minFrequency, double maxFrequency, int style)
+    {
+        MelFilterKey key = {paddedLength, sampleRate, numFilters, minFrequency, maxFrequency, style};
+        std::lock_guard<std::mutex> lock (melFilterCacheMutex);
+
+        std::map<MelFilterKey, MelFilterBank>::iterator cached = melFilterCache.find (key);
+
+        if (cached != melFilterCache.end())
+        {
+            return &cached->second.filters;
+        }
+
+        MelFilterBank& bank = melFilterCache [key];
+
+        // each filter gets paddedLength samples, as xtract_mfcc always gave them
+        bank.storage.resize (numFilters * paddedLength, 0);
+        bank.filterArrays.resize (numFilters);
+
+        for (int n = 0; n < numFilters; ++n)
+        {
+            bank.filterArrays [n] = &bank.storage [n * paddedLength];
+        }
+
+        bank.filters.n_filters = numFilters;
+        bank.filters.filters = &bank.filterArrays [0];
+
+        xtract_init_mfcc (paddedLength / 2, sampleRate / 2, style, minFrequency, maxFrequency,
+                          bank.filters.n_filters, bank.filters.filters);
+
+        return &bank.filters;
+    }
+
+    void clearMelFilterCache()
+    {
+        std::lock_guard<std::mutex> lock (melFilterCacheMutex);
+        melFilterCache.clear();
+    }
+}
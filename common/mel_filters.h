@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_MEL_FILTERS_H
+#define XTRACT_OCTAVE_MEL_FILTERS_H
+
+#include <xtract/libxtract.h>
+
+namespace XtractOctave
+{
+    // Get a mel filter bank for spectra paddedLength samples long.
+    //
+    // The filters are built with xtract_init_mfcc the first time a set of
+    // settings is asked for and kept for the rest of the session, so a bank
+    // is only ever built once. style is XTRACT_EQUAL_GAIN or
+    // XTRACT_EQUAL_AREA.
+    xtract_mel_filter* getMelFilters (int paddedLength, double sampleRate, int numFilters,
+                                      double minFrequency, double maxFrequency, int style);
+
+    // Free all the mel filter banks which have been built.
+    void clearMelFilterCache();
+}
+
+#endif
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "options.h"
+#include "spectral_stream.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        const char* optionNames [] = {"framesize", "hopsize", "window", "input", "fftsize", "precision", "threads", "peakthreshold", "maxpeaks", "stream", "output"};
+        const int numOptionNames = sizeof (optionNames) / sizeof (optionNames [0]);
+
+        std::string toLower (std::string text)
+        {
+            std::transform (text.begin(), text.end(), text.begin(), ::tolower);
+            return text;
+        }
+
+        bool isOptionName (const octave_value& arg)
+        {
+            if (! arg.is_string())
+            {
+                return false;
+            }
+
+            std::string name = toLower (arg.string_value());
+
+            for (int i = 0; i < numOptionNames; ++i)
+            {
+                if (name == optionNames [i])
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    }
+
+    Options::Options()
+      : frameSize (0),
+        hopSize (0),
+        window ("rectangular"),
+        windowParameter (std::numeric_limits<double>::quiet_NaN()),
+        input ("signal"),
+        fftSize ("pow2"),
+        singlePrecision (false),
+        numThreads (1),
+        peakThreshold (10),
+        maxPeaks (0),
+        stream (0)
+    {
+    }
+
+    int parseOptions (const octave_value_list& args, Options& options)
+    {
+        // find where the options start, the first argument is never an
+        // option but there may not be one at all
+        int numArgs = std::min (1, (int) args.length());
+        while (numArgs < args.length() && ! isOptionName (args (numArgs)))
+        {
+            ++numArgs;
+        }
+
+        for (int i = numArgs; i < args.length(); i += 2)
+        {
+            if (! isOptionName (args (i)))
+            {
+                error ("unrecognised option");
+                return -1;
+            }
+
+            if (i + 1 == args.length())
+            {
+                error ("option \"%s\" has no value", args (i).string_value().c_str());
+                return -1;
+            }
+
+            std::string name = toLower (args (i).string_value());
+            const octave_value& value = args (i + 1);
+
+            if (name == "framesize")
+            {
+                options.frameSize = value.int_value();
+
+                if (options.frameSize < 1)
+                {
+                    error ("framesize must be at least 1");
+                    return -1;
+                }
+            }
+            else if (name == "hopsize")
+            {
+                options.hopSize = value.int_value();
+
+                if (options.hopSize < 1)
+                {
+                    error ("hopsize must be at least 1");
+                    return -1;
+                }
+            }
+            else if (name == "window")
+            {
+                if (value.iscell())
+                {
+                    Cell window = value.cell_value();
+
+                    if (window.numel() != 2 || ! window (0).is_string())
+                    {
+                        error ("window must be a name or a cell array of a name and its parameter");
+                        return -1;
+                    }
+
+                    options.window = toLower (window (0).string_value());
+                    options.windowParameter = window (1).double_value();
+
+                    if (! (options.windowParameter >= 0))
+                    {
+                        error ("the window's parameter must be at least 0");
+                        return -1;
+                    }
+                }
+                else
+                {
+                    options.window = toLower (value.string_value());
+                }
+            }
+            else if (name == "input")
+            {
+                options.input = toLower (value.string_value());
+            }
+            else if (name == "fftsize")
+            {
+                options.fftSize = toLower (value.string_value());
+            }
+            else if (name == "precision")
+            {
+                std::string precision = toLower (value.string_value());
+
+                if (precision != "double" && precision != "single")
+                {
+                    error ("precision must be either \"double\" or \"single\"");
+                    return -1;
+                }
+
+                options.singlePrecision = (precision == "single");
+            }
+            else if (name == "threads")
+            {
+                options.numThreads = value.int_value();
+
+                if (options.numThreads < 0)
+                {
+                    error ("threads must be at least 0");
+                    return -1;
+                }
+
+                if (options.numThreads == 0)
+                {
+                    options.numThreads = getNumHardwareThreads();
+                }
+            }
+            else if (name == "peakthreshold")
+            {
+                options.peakThreshold = value.double_value();
+
+                if (! ((options.peakThreshold >= 0) && (options.peakThreshold <= 100)))
+                {
+                    error ("peakthreshold must be between 0 and 100");
+                    return -1;
+                }
+            }
+            else if (name == "maxpeaks")
+            {
+                options.maxPeaks = value.int_value();
+
+                if (options.maxPeaks < 0)
+                {
+                    error ("maxpeaks must be at least 0");
+                    return -1;
+                }
+            }
+            else if (name == "output")
+            {
+                if (! value.is_string())
+                {
+                    error ("output must be the name of a file");
+                    return -1;
+                }
+
+                options.output = value.string_value();
+            }
+            else if (name == "stream")
+            {
+                options.stream = value.int_value();
+
+                if (getSpectralStreams().get (options.stream) == NULL)
+                {
+                    error ("there is no stream with handle %d", options.stream);
+                    return -1;
+                }
+            }
+        }
+
+        // frames don't overlap unless a hop size is given
+        if (options.hopSize == 0)
+        {
+            options.hopSize = options.frameSize;
+        }
+        else if (options.frameSize == 0)
+        {
+            error ("hopsize can only be used with framesize");
+            return -1;
+        }
+
+        return numArgs;
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_OPTIONS_H
+#define XTRACT_OCTAVE_OPTIONS_H
+
+#include <octave/oct.h>
+#include <string>
+
+namespace XtractOctave
+{
+    // The options which can be given to any of the wrappers as name, value
+    // pairs after their usual arguments.
+    struct Options
+    {
+        Options();
+
+        // "framesize" and "hopsize", if frameSize is 0 the data is already
+        // split into frames
+        int frameSize;
+        int hopSize;
+
+        // "window", the window applied to each frame before its spectrum is
+        // found, given either as a name or as a cell array of the name and
+        // its parameter (the kaiser window's beta, NaN if not given)
+        std::string window;
+        double windowParameter;
+
+        // "input", whether the data is the "signal" (the default) or its
+        // "spectrum" as xtract_spectrum lays it out
+        std::string input;
+
+        // "fftsize", how the fft length is chosen from the frame length:
+        // "pow2" (the default), "fast" or "exact" (see findFFTLength)
+        std::string fftSize;
+
+        // "precision", true if the ffts should be done in "single" rather
+        // than "double" (the default) precision
+        bool singlePrecision;
+
+        // "threads", the number of threads a batch of frames is shared
+        // between (0 asks for one per processor)
+        int numThreads;
+
+        // "peakthreshold", the percentage of the largest magnitude a spectral
+        // peak must reach (10 by default), and "maxpeaks", the number of the
+        // largest peaks to keep (0, the default, keeps them all, see PeakPicker)
+        double peakThreshold;
+        int maxPeaks;
+
+        // "stream", the handle of a SpectralStream whose latest spectra are
+        // used in place of the data (0, the default, for none)
+        int stream;
+
+        // "output", the path of a feature file (see FeatureFile) for the
+        // extractors to write their results to instead of returning them,
+        // empty (the default) to return them
+        std::string output;
+    };
+
+    // Read any options from the end of args.
+    //
+    // The options start at the first string argument (after the data) which
+    // is the name of an option. Returns the number of arguments before the
+    // options, or -1 after raising an error if the options are invalid.
+    int parseOptions (const octave_value_list& args, Options& options);
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "peaks.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        template <typename Peak>
+        bool isLouder (const Peak& a, const Peak& b)
+        {
+            return a.magnitude > b.magnitude;
+        }
+
+        template <typename Peak>
+        bool isLower (const Peak& a, const Peak& b)
+        {
+            return a.bin < b.bin;
+        }
+    }
+
+    PeakPicker::PeakPicker (int paddedLength, double sampleRateByNToUse, double thresholdToUse, int maxPeaksToUse)
+      : numBins (paddedLength / 2),
+        sampleRateByN (sampleRateByNToUse),
+        threshold (thresholdToUse),
+        maxPeaks (std::min (maxPeaksToUse, paddedLength / 2))
+    {
+        candidates.reserve (numBins);
+    }
+
+    int PeakPicker::getPeakSpectrumLength() const
+    {
+        return isSparse() ? 2 * maxPeaks : 2 * numBins;
+    }
+
+    bool PeakPicker::isSparse() const
+    {
+        return maxPeaks > 0;
+    }
+
+    int PeakPicker::findPeaks (const double* spectrum, double* result)
+    {
+        double highest = 0;
+
+        for (int n = 0; n < numBins; ++n)
+        {
+            highest = std::max (highest, spectrum [n]);
+        }
+
+        double minimum = threshold * 0.01 * highest;
+
+        // find every peak above the threshold, interpolating its magnitude
+        // and frequency as xtract_peak_spectrum does
+        candidates.clear();
+
+        for (int n = 1; n + 1 < numBins; ++n)
+        {
+            double y1 = spectrum [n - 1];
+            double y2 = spectrum [n];
+            double y3 = spectrum [n + 1];
+
+            if (y2 >= minimum && y2 > y1 && y2 > y3)
+            {
+                double p = 0.5 * (y1 - y3) / (y1 - 2 * y2 + y3);
+
+                Peak peak = {n, y2 - 0.25 * (y1 - y3) * p, sampleRateByN * (n + p)};
+                candidates.push_back (peak);
+            }
+        }
+
+        int numPeaks = candidates.size();
+
+        if (! isSparse())
+        {
+            memset (result, 0, 2 * numBins * sizeof (double));
+
+            for (int i = 0; i < numPeaks; ++i)
+            {
+                result [candidates [i].bin] = candidates [i].magnitude;
+                result [numBins + candidates [i].bin] = candidates [i].frequency;
+            }
+
+            return numPeaks;
+        }
+
+        // keep the largest peaks, in order of frequency so the harmonic
+        // features see them in the same order as in a full peak spectrum
+        if (numPeaks > maxPeaks)
+        {
+            std::nth_element (candidates.begin(), candidates.begin() + maxPeaks, candidates.end(), isLouder<Peak>);
+            numPeaks = maxPeaks;
+            std::sort (candidates.begin(), candidates.begin() + numPeaks, isLower<Peak>);
+        }
+
+        memset (result, 0, 2 * maxPeaks * sizeof (double));
+
+        for (int i = 0; i < numPeaks; ++i)
+        {
+            result [i] = candidates [i].magnitude;
+            result [maxPeaks + i] = candidates [i].frequency;
+        }
+
+        return numPeaks;
+    }
+
+    double findOddEvenRatio (const double* harmonics, int numPeaks, double f0)
+    {
+        double odd = 0;
+        double even = 0;
+
+        for (int i = 0; i < numPeaks; ++i)
+        {
+            if (harmonics [i] > 0 && f0 > 0)
+            {
+                long harmonic = lround (harmonics [numPeaks + i] / f0);
+
+                if (harmonic % 2 == 1)
+                {
+                    odd += harmonics [i];
+                }
+                else
+                {
+                    even += harmonics [i];
+                }
+            }
+        }
+
+        return even > 0 ? odd / even : 0;
+    }
+}
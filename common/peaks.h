@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_PEAKS_H
+#define XTRACT_OCTAVE_PEAKS_H
+
+#include <vector>
+
+namespace XtractOctave
+{
+    // Finds the peaks of spectra laid out as xtract_spectrum lays them out.
+    //
+    // A peak is a magnitude larger than both its neighbours and at least
+    // threshold percent of the largest magnitude in the spectrum, its
+    // magnitude and frequency are interpolated from a parabola through the
+    // three bins in the same way as xtract_peak_spectrum does.
+    //
+    // By default the peaks are written out as xtract_peak_spectrum writes
+    // them, paddedLength / 2 magnitudes followed by paddedLength / 2
+    // frequencies with zeros in every bin which isn't a peak. Given a
+    // maximum number of peaks K the result is sparse instead, K magnitudes
+    // followed by K frequencies holding only the K largest peaks in order
+    // of frequency (padded with zeros if there are fewer). Either way the
+    // result can be passed straight to xtract_harmonic_spectrum and the
+    // harmonic features as a spectrum getPeakSpectrumLength() long, so with
+    // a small K they only have K entries to look through.
+    class PeakPicker
+    {
+    public:
+        PeakPicker (int paddedLength, double sampleRateByN, double threshold = 10, int maxPeaks = 0);
+
+        // the length of the peak spectra findPeaks writes
+        int getPeakSpectrumLength() const;
+
+        // true if only the largest peaks are kept
+        bool isSparse() const;
+
+        // find the peaks of a spectrum, returns the number found
+        int findPeaks (const double* spectrum, double* result);
+
+    private:
+        struct Peak
+        {
+            int bin;
+            double magnitude;
+            double frequency;
+        };
+
+        int numBins;
+        double sampleRateByN;
+        double threshold;
+        int maxPeaks;
+        std::vector<Peak> candidates;
+    };
+
+    // The odd to even harmonic ratio of a sparse harmonic spectrum
+    // numPeaks * 2 long, each harmonic is counted as odd or even by its
+    // harmonic number rather than the bin it lies in, as the bins are lost
+    // once the peaks have been packed together.
+    double findOddEvenRatio (const double* harmonics, int numPeaks, double f0);
+}
+
+#endif
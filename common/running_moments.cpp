@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "running_moments.h"
+#include <algorithm>
+#include <cmath>
+
+namespace XtractOctave
+{
+    RunningMoments::RunningMoments()
+    {
+        reset();
+    }
+
+    void RunningMoments::add (double value)
+    {
+        double previousCount = count;
+        count += 1;
+
+        double delta = value - mean;
+        double deltaByN = delta / count;
+        double deltaByNSquared = deltaByN * deltaByN;
+        double term = delta * deltaByN * previousCount;
+
+        mean += deltaByN;
+        m4 += term * deltaByNSquared * (count * count - 3 * count + 3) + 6 * deltaByNSquared * m2 - 4 * deltaByN * m3;
+        m3 += term * deltaByN * (count - 2) - 3 * deltaByN * m2;
+        m2 += term;
+
+        minimum = std::min (minimum, value);
+        maximum = std::max (maximum, value);
+    }
+
+    void RunningMoments::merge (const RunningMoments& other)
+    {
+        if (other.count == 0)
+        {
+            return;
+        }
+
+        if (count == 0)
+        {
+            *this = other;
+            return;
+        }
+
+        double countA = count;
+        double countB = other.count;
+        double total = countA + countB;
+
+        double delta = other.mean - mean;
+        double delta2 = delta * delta;
+        double delta3 = delta2 * delta;
+        double delta4 = delta2 * delta2;
+
+        double newMean = (countA * mean + countB * other.mean) / total;
+
+        double newM2 = m2 + other.m2 + delta2 * countA * countB / total;
+
+        double newM3 = m3 + other.m3
+                     + delta3 * countA * countB * (countA - countB) / (total * total)
+                     + 3 * delta * (countA * other.m2 - countB * m2) / total;
+
+        double newM4 = m4 + other.m4
+                     + delta4 * countA * countB * (countA * countA - countA * countB + countB * countB) / (total * total * total)
+                     + 6 * delta2 * (countA * countA * other.m2 + countB * countB * m2) / (total * total)
+                     + 4 * delta * (countA * other.m3 - countB * m3) / total;
+
+        count = total;
+        mean = newMean;
+        m2 = newM2;
+        m3 = newM3;
+        m4 = newM4;
+        minimum = std::min (minimum, other.minimum);
+        maximum = std::max (maximum, other.maximum);
+    }
+
+    void RunningMoments::reset()
+    {
+        count = 0;
+        mean = 0;
+        m2 = 0;
+        m3 = 0;
+        m4 = 0;
+        minimum = INFINITY;
+        maximum = -INFINITY;
+    }
+
+    double RunningMoments::getCount() const
+    {
+        return count;
+    }
+
+    double RunningMoments::getMean() const
+    {
+        return (count > 0) ? mean : NAN;
+    }
+
+    double RunningMoments::getVariance() const
+    {
+        if (count == 0)
+        {
+            return NAN;
+        }
+
+        return (count > 1) ? m2 / (count - 1) : 0;
+    }
+
+    double RunningMoments::getSkewness() const
+    {
+        return (m2 > 0) ? sqrt (count) * m3 / pow (m2, 1.5) : NAN;
+    }
+
+    double RunningMoments::getKurtosis() const
+    {
+        return (m2 > 0) ? count * m4 / (m2 * m2) : NAN;
+    }
+
+    double RunningMoments::getMinimum() const
+    {
+        return (count > 0) ? minimum : NAN;
+    }
+
+    double RunningMoments::getMaximum() const
+    {
+        return (count > 0) ? maximum : NAN;
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_RUNNING_MOMENTS_H
+#define XTRACT_OCTAVE_RUNNING_MOMENTS_H
+
+namespace XtractOctave
+{
+    // The mean, variance, skewness and kurtosis of a series of values, kept
+    // up to date as each value arrives.
+    //
+    // Only the count, mean and the sums of the 2nd, 3rd and 4th powers of
+    // the deviations from the mean are held, updated with Welford's method
+    // (extended to the higher moments by Pébay) so they stay accurate over
+    // very long series. Two sets of moments can be merged, so a series can
+    // be split between threads and the results combined afterwards.
+    class RunningMoments
+    {
+    public:
+        RunningMoments();
+
+        void add (double value);
+
+        // add all the values other has seen, as if they had been added here
+        void merge (const RunningMoments& other);
+
+        void reset();
+
+        double getCount() const;
+        double getMean() const;
+
+        // the unbiased variance, as Octave's var finds it
+        double getVariance() const;
+
+        // the skewness and kurtosis as Octave's skewness and kurtosis find
+        // them (the kurtosis of a normal distribution being 3)
+        double getSkewness() const;
+        double getKurtosis() const;
+
+        double getMinimum() const;
+        double getMaximum() const;
+
+    private:
+        double count;
+        double mean;
+        double m2;
+        double m3;
+        double m4;
+        double minimum;
+        double maximum;
+    };
+}
+
+#endif
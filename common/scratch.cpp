@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "scratch.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        const int alignment = 64;
+        const int alignmentPadding = alignment / sizeof (double);
+
+        struct AlignedBuffer
+        {
+            std::vector<double> storage;
+            double* data;
+            int length;
+
+            AlignedBuffer() : data (0), length (0) {}
+        };
+
+        struct ScratchArena
+        {
+            AlignedBuffer buffers [numScratchBuffers];
+        };
+
+        // a deque so growing it doesn't move the arenas other threads are using
+        std::deque<ScratchArena> arenas;
+        std::mutex arenasMutex;
+    }
+
+    double* getScratch (ScratchBuffer buffer, int length, int thread)
+    {
+        AlignedBuffer* scratch;
+
+        {
+            std::lock_guard<std::mutex> lock (arenasMutex);
+
+            if (thread >= (int) arenas.size())
+            {
+                arenas.resize (thread + 1);
+            }
+
+            scratch = &arenas [thread].buffers [buffer];
+        }
+
+        if (length > scratch->length)
+        {
+            scratch->storage.assign (length + alignmentPadding, 0);
+
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t> (&scratch->storage [0]);
+            std::uintptr_t offset = (alignment - address % alignment) % alignment;
+
+            scratch->data = &scratch->storage [0] + offset / sizeof (double);
+            scratch->length = length;
+        }
+
+        return scratch->data;
+    }
+
+    float* getFloatScratch (ScratchBuffer buffer, int length, int thread)
+    {
+        int numDoubles = (length * sizeof (float) + sizeof (double) - 1) / sizeof (double);
+        return reinterpret_cast<float*> (getScratch (buffer, numDoubles, thread));
+    }
+
+    void clearScratch()
+    {
+        std::lock_guard<std::mutex> lock (arenasMutex);
+        arenas.clear();
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_SCRATCH_H
+#define XTRACT_OCTAVE_SCRATCH_H
+
+namespace XtractOctave
+{
+    // The buffers held in each scratch arena.
+    enum ScratchBuffer
+    {
+        paddedInputBuffer,
+        spectrumBuffer,
+        blockSpectraBuffer,
+        peaksBuffer,
+        harmonicsBuffer,
+        frameBuffer,
+        numScratchBuffers
+    };
+
+    // Get a buffer of at least length doubles from the scratch arena of a
+    // thread (0 being the thread Octave calls us on).
+    //
+    // The arenas are kept for the whole session and their buffers only ever
+    // grow, so after the first call with a given length no memory is
+    // allocated. Buffers start on a 64 byte boundary so the compiler's
+    // vectorised loops and memcpy can use aligned loads. The contents are
+    // whatever the last user left in them, and each buffer of an arena must
+    // only be used by one object at a time.
+    double* getScratch (ScratchBuffer buffer, int length, int thread = 0);
+
+    // The same buffer as getScratch gives, as room for length floats.
+    float* getFloatScratch (ScratchBuffer buffer, int length, int thread = 0);
+
+    // Free all the scratch arenas.
+    void clearScratch();
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "spectral_statistics.h"
+#include "analysis.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <memory>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        HandleRegistry<SpectralStatistics> spectralStatistics;
+    }
+
+    SpectralStatistics::SpectralStatistics (double sampleRateToUse, const std::vector<const Feature*>& featuresToUse)
+      : sampleRate (sampleRateToUse),
+        features (featuresToUse),
+        moments (featuresToUse.size())
+    {
+    }
+
+    void SpectralStatistics::addFrames (const Frames& frames, const Options& options)
+    {
+        int numFrames = frames.getNumFrames();
+        int numFeatures = features.size();
+        int numThreads = std::max (1, std::min (options.numThreads, numFrames));
+
+        // each thread gets its own analysis and moments
+        std::vector<std::unique_ptr<FrameAnalysis> > analyses;
+        std::vector<std::vector<RunningMoments> > threadMoments (numThreads, std::vector<RunningMoments> (numFeatures));
+
+        for (int thread = 0; thread < numThreads; ++thread)
+        {
+            analyses.push_back (std::unique_ptr<FrameAnalysis> (
+                new FrameAnalysis (frames.getFrameLength(), sampleRate, frames.getWindow(),
+                                   numThreads > 1, thread, frames.getFFTLength(),
+                                   options.singlePrecision)));
+            analyses [thread]->setInputIsSpectrum (frames.isSpectrum());
+        }
+
+        // work through the frames a block at a time so an interrupt is
+        // noticed between blocks
+        int blockLength = numThreads > 1 ? numThreads * 16 : 1;
+
+        for (int blockStart = 0; blockStart < numFrames; blockStart += blockLength)
+        {
+            OCTAVE_QUIT;
+
+            int numBlockFrames = std::min (blockLength, numFrames - blockStart);
+
+            parallelFor (numBlockFrames, numThreads, [&] (int first, int last, int thread)
+            {
+                FrameAnalysis& analysis = *analyses [thread];
+
+                for (int frame = blockStart + first; frame < blockStart + last; ++frame)
+                {
+                    if (frames.isSingle())
+                    {
+                        analysis.setFrame (frames.getSingleFrame (frame), 0);
+                    }
+                    else
+                    {
+                        analysis.setFrame (frames.getFrame (frame), 0);
+                    }
+
+                    for (int i = 0; i < numFeatures; ++i)
+                    {
+                        double value = 0;
+                        features [i]->extract (analysis, &value);
+                        threadMoments [thread][i].add (value);
+                    }
+                }
+            });
+        }
+
+        for (int thread = 0; thread < numThreads; ++thread)
+        {
+            for (int i = 0; i < numFeatures; ++i)
+            {
+                moments [i].merge (threadMoments [thread][i]);
+            }
+        }
+    }
+
+    void SpectralStatistics::merge (const SpectralStatistics& other)
+    {
+        for (size_t i = 0; i < moments.size(); ++i)
+        {
+            moments [i].merge (other.moments [i]);
+        }
+    }
+
+    void SpectralStatistics::reset()
+    {
+        for (size_t i = 0; i < moments.size(); ++i)
+        {
+            moments [i].reset();
+        }
+    }
+
+    double SpectralStatistics::getSampleRate() const
+    {
+        return sampleRate;
+    }
+
+    const std::vector<const Feature*>& SpectralStatistics::getFeatures() const
+    {
+        return features;
+    }
+
+    const RunningMoments& SpectralStatistics::getMoments (int feature) const
+    {
+        return moments [feature];
+    }
+
+    HandleRegistry<SpectralStatistics>& getSpectralStatistics()
+    {
+        return spectralStatistics;
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_SPECTRAL_STATISTICS_H
+#define XTRACT_OCTAVE_SPECTRAL_STATISTICS_H
+
+#include "features.h"
+#include "frames.h"
+#include "handles.h"
+#include "options.h"
+#include "running_moments.h"
+#include <vector>
+
+namespace XtractOctave
+{
+    // Summary statistics of several features over any number of frames.
+    //
+    // Each batch of frames added is analysed once, with the spectrum and
+    // spectral moments shared between the features as xtract_features
+    // shares them, and only the running moments of each feature are kept so
+    // the memory used doesn't grow with the number of frames. When a batch
+    // is shared between threads each thread keeps its own moments, which
+    // are merged in thread order at the end.
+    class SpectralStatistics
+    {
+    public:
+        // features must each have a single value per frame and not need an f0
+        SpectralStatistics (double sampleRate, const std::vector<const Feature*>& features);
+
+        void addFrames (const Frames& frames, const Options& options);
+
+        // add everything other has seen, it must track the same features
+        void merge (const SpectralStatistics& other);
+
+        void reset();
+
+        double getSampleRate() const;
+        const std::vector<const Feature*>& getFeatures() const;
+        const RunningMoments& getMoments (int feature) const;
+
+    private:
+        double sampleRate;
+        std::vector<const Feature*> features;
+        std::vector<RunningMoments> moments;
+    };
+
+    // the accumulators created by xtract_spectral_statistics
+    HandleRegistry<SpectralStatistics>& getSpectralStatistics();
+}
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "spectral_stream.h"
+#include "fft.h"
+#include "spectrum.h"
+#include "window.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        HandleRegistry<SpectralStream> spectralStreams;
+    }
+
+    SpectralStream::SpectralStream (double sampleRateToUse, int frameSizeToUse, int hopSizeToUse, const Options& options,
+                                    Method methodToUse, int resyncIntervalToUse)
+      : sampleRate (sampleRateToUse),
+        frameSize (frameSizeToUse),
+        hopSize (hopSizeToUse),
+        paddedLength (findFFTLength (frameSizeToUse, options.fftSize)),
+        singlePrecision (options.singlePrecision),
+        ring (frameSizeToUse, 0),
+        writePosition (0),
+        numToNextFrame (frameSizeToUse),
+        spectra (dim_vector (paddedLength, 0)),
+        method (methodToUse),
+        resyncInterval (resyncIntervalToUse > 0 ? resyncIntervalToUse : std::max (1, frameSizeToUse / hopSizeToUse)),
+        numSinceResync (0)
+    {
+        if (paddedLength == 0)
+        {
+            error ("unknown fftsize \"%s\"", options.fftSize.c_str());
+            return;
+        }
+
+        // the stream outlives the call, so it keeps its own copy of the
+        // window rather than pointing into the cache
+        const double* table = NULL;
+
+        if (! findWindow (options.window, options.windowParameter, frameSize, table))
+        {
+            error ("unknown window \"%s\"", options.window.c_str());
+            return;
+        }
+
+        if (table != NULL)
+        {
+            window.assign (table, table + frameSize);
+        }
+
+        if (method == slidingMethod)
+        {
+            if (! window.empty())
+            {
+                error ("the sliding method can only use a rectangular window");
+                return;
+            }
+
+            // each new sample enters the padded frame at frameSize - 1 and
+            // the frame moves one sample earlier, which turns every bin k by
+            // exp (2 pi i k / N)
+            int numBins = paddedLength / 2 + 1;
+            double step = 2 * M_PI / paddedLength;
+
+            fft.reset (new RealFFT (paddedLength));
+            unrolled.resize (paddedLength, 0);
+            bins.resize (numBins, 0);
+            rotations.resize (numBins);
+            entries.resize (numBins);
+
+            for (int k = 0; k < numBins; ++k)
+            {
+                rotations [k] = std::polar (1.0, step * k);
+                entries [k] = std::polar (1.0, -step * fmod ((double) k * (frameSize - 1), paddedLength));
+            }
+        }
+    }
+
+    int SpectralStream::process (const double* samples, int numSamples)
+    {
+        int maxFrames = (numSamples >= numToNextFrame) ? 1 + (numSamples - numToNextFrame) / hopSize : 0;
+        spectra = NDArray (dim_vector (paddedLength, maxFrames));
+        double* result = spectra.fortran_vec();
+
+        if (method == slidingMethod)
+        {
+            return processSliding (samples, numSamples, result);
+        }
+
+        // the analyser's buffers are shared with the other functions, so it
+        // only lives for this block
+        SpectrumAnalyser analyser (frameSize, sampleRate, window.empty() ? NULL : &window [0],
+                                   false, 0, paddedLength, singlePrecision);
+
+        int numFrames = 0;
+
+        while (numSamples > 0)
+        {
+            int blockLength = std::min (numSamples, numToNextFrame);
+
+            // only the last frameSize samples of a block can end up in a
+            // frame, the ones before them are skipped over
+            int numSkipped = std::max (0, blockLength - frameSize);
+            writePosition = (writePosition + numSkipped) % frameSize;
+
+            for (int i = numSkipped; i < blockLength; )
+            {
+                int length = std::min (blockLength - i, frameSize - writePosition);
+                std::memcpy (&ring [writePosition], samples + i, length * sizeof (double));
+                writePosition = (writePosition + length) % frameSize;
+                i += length;
+            }
+
+            samples += blockLength;
+            numSamples -= blockLength;
+            numToNextFrame -= blockLength;
+
+            if (numToNextFrame == 0)
+            {
+                const double* spectrum = analyser.findSpectrum (&ring [0], writePosition);
+                std::copy (spectrum, spectrum + paddedLength, result + numFrames * paddedLength);
+                ++numFrames;
+
+                numToNextFrame = hopSize;
+            }
+        }
+
+        return numFrames;
+    }
+
+    int SpectralStream::processSliding (const double* samples, int numSamples, double* result)
+    {
+        int numBins = bins.size();
+        int halfN = paddedLength / 2;
+        double sampleRateByN = (sampleRate == 0 ? 44100.0 : sampleRate) / paddedLength;
+        int numFrames = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // the oldest sample leaves the frame as the new one enters it
+            double oldest = ring [writePosition];
+            double newest = samples [i];
+            ring [writePosition] = newest;
+            writePosition = (writePosition + 1) % frameSize;
+
+            for (int k = 0; k < numBins; ++k)
+            {
+                bins [k] = rotations [k] * (bins [k] - oldest) + newest * entries [k];
+            }
+
+            if (--numToNextFrame == 0)
+            {
+                if (++numSinceResync >= resyncInterval)
+                {
+                    resynchronise();
+                }
+
+                // laid out as RealFFT::magnitudeSpectrum lays it out
+                double* spectrum = result + numFrames * paddedLength;
+
+                for (int m = 0; m < halfN; ++m)
+                {
+                    spectrum [m] = std::abs (bins [m + 1]) / paddedLength;
+                    spectrum [halfN + m] = (m + 1) * sampleRateByN;
+                }
+
+                ++numFrames;
+                numToNextFrame = hopSize;
+            }
+        }
+
+        return numFrames;
+    }
+
+    void SpectralStream::resynchronise()
+    {
+        std::copy (ring.begin() + writePosition, ring.end(), unrolled.begin());
+        std::copy (ring.begin(), ring.begin() + writePosition, unrolled.begin() + (frameSize - writePosition));
+        fft->transform (&unrolled [0], &bins [0]);
+        numSinceResync = 0;
+    }
+
+    void SpectralStream::reset()
+    {
+        std::fill (ring.begin(), ring.end(), 0);
+        writePosition = 0;
+        numToNextFrame = frameSize;
+        spectra = NDArray (dim_vector (paddedLength, 0));
+
+        // an empty frame has empty bins
+        std::fill (bins.begin(), bins.end(), 0);
+        numSinceResync = 0;
+    }
+
+    const NDArray& SpectralStream::getSpectra() const
+    {
+        return spectra;
+    }
+
+    SpectralStream::Method SpectralStream::getMethod() const
+    {
+        return method;
+    }
+
+    double SpectralStream::getSampleRate() const
+    {
+        return sampleRate;
+    }
+
+    int SpectralStream::getFrameSize() const
+    {
+        return frameSize;
+    }
+
+    int SpectralStream::getHopSize() const
+    {
+        return hopSize;
+    }
+
+    int SpectralStream::getPaddedLength() const
+    {
+        return paddedLength;
+    }
+
+    HandleRegistry<SpectralStream>& getSpectralStreams()
+    {
+        return spectralStreams;
+    }
+}
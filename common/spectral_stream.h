@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_SPECTRAL_STREAM_H
+#define XTRACT_OCTAVE_SPECTRAL_STREAM_H
+
+#include <octave/oct.h>
+#include "fft.h"
+#include "handles.h"
+#include "options.h"
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XtractOctave
+{
+    // Finds the spectra of a signal which arrives in blocks of any length.
+    //
+    // The samples are written once into a ring buffer holding the current
+    // frame, and each time a hop's worth of new samples completes a frame
+    // its spectrum is found straight from the ring, so overlapping frames
+    // cost one fft per hop and nothing more. The spectra of the frames
+    // completed by the last block are kept (laid out as xtract_spectrum
+    // lays them out, one per column) so that any of the spectral functions
+    // can be run on them through their "stream" option without finding
+    // them again.
+    //
+    // With the sliding method the bins are instead updated as each sample
+    // arrives with a sliding dft, which costs O(N) a sample rather than
+    // O(N log N) a frame and so wins for hops of a few samples. Rounding
+    // errors build up in the running bins, so every resyncInterval frames
+    // they are found again with a full fft. The sliding dft can't apply a
+    // window, so the frames are rectangular and double precision.
+    class SpectralStream
+    {
+    public:
+        enum Method
+        {
+            // a full fft of each frame
+            fftMethod,
+
+            // a sliding dft, resynchronised with a full fft
+            slidingMethod
+        };
+
+        // the window, fftsize and precision are taken from the options,
+        // resyncInterval is only used by the sliding method (0 resyncs
+        // about once every frameSize samples)
+        SpectralStream (double sampleRate, int frameSize, int hopSize, const Options& options,
+                        Method method = fftMethod, int resyncInterval = 0);
+
+        // feed the next block of the signal, returns the number of frames
+        // it completed
+        int process (const double* samples, int numSamples);
+
+        // forget the buffered samples and spectra
+        void reset();
+
+        // the spectra of the frames completed by the last block
+        const NDArray& getSpectra() const;
+
+        double getSampleRate() const;
+        int getFrameSize() const;
+        int getHopSize() const;
+        int getPaddedLength() const;
+        Method getMethod() const;
+
+    private:
+        int processSliding (const double* samples, int numSamples, double* result);
+
+        // find the bins of the current frame with a full fft
+        void resynchronise();
+
+        double sampleRate;
+        int frameSize;
+        int hopSize;
+        int paddedLength;
+        bool singlePrecision;
+        std::vector<double> window;
+
+        // the current frame, oldest sample first from writePosition on
+        std::vector<double> ring;
+        int writePosition;
+
+        // the samples still needed to complete the next frame
+        int numToNextFrame;
+
+        NDArray spectra;
+
+        // only used by the sliding method
+        Method method;
+        int resyncInterval;
+        int numSinceResync;
+        std::unique_ptr<RealFFT> fft;
+        std::vector<double> unrolled;
+        std::vector<std::complex<double> > bins;
+        std::vector<std::complex<double> > rotations;
+        std::vector<std::complex<double> > entries;
+    };
+
+    // the streams created by xtract_spectral_stream
+    HandleRegistry<SpectralStream>& getSpectralStreams();
+}
+
+#endif
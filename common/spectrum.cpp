@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "spectrum.h"
+#include "fft_cache.h"
+#include "frames.h"
+#include "options.h"
+#include "scratch.h"
+#include "thread_pool.h"
+#include <xtract/libxtract.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        // the most frames each thread is given in a block, fewer when the
+        // spectra are long enough that a block would pass maxBlockBytes
+        const int maxFramesPerThread = 64;
+        const size_t maxBlockBytes = 64 * 1024 * 1024;
+    }
+
+    SpectrumAnalyser::SpectrumAnalyser (int inputLengthToUse, double sampleRate, const double* windowToUse,
+                                        bool privatePlan, int thread, int fftLength,
+                                        bool singlePrecision)
+      : frames (NULL),
+        inputLength (inputLengthToUse),
+        paddedLength (fftLength > 0 ? fftLength : findFFTLength (inputLength, "pow2")),
+        sampleRateByN (sampleRate / paddedLength),
+        window (windowToUse),
+        paddedInput (NULL),
+        spectrum (getScratch (spectrumBuffer, paddedLength, thread)),
+        singlePaddedInput (NULL),
+        numThreads (1),
+        blockFramesPerThread (1),
+        blockSpectra (NULL),
+        blockStart (0),
+        blockLength (0)
+    {
+        // the scratch buffer may hold anything so clear the zero padding,
+        // the frames are only ever copied over the start of it
+        if (singlePrecision)
+        {
+            singlePaddedInput = getFloatScratch (paddedInputBuffer, paddedLength, thread);
+            std::memset (singlePaddedInput + inputLength, 0, (paddedLength - inputLength) * sizeof (float));
+            singleFFT.reset (new FloatRealFFT (paddedLength));
+            return;
+        }
+
+        paddedInput = getScratch (paddedInputBuffer, paddedLength, thread);
+        std::memset (paddedInput + inputLength, 0, (paddedLength - inputLength) * sizeof (double));
+
+        // LibXtract's fft can only be relied on for powers of 2
+        bool isPowerOfTwo = (paddedLength & (paddedLength - 1)) == 0;
+
+        if (privatePlan || ! isPowerOfTwo)
+        {
+            fft.reset (new RealFFT (paddedLength));
+        }
+        else
+        {
+            initialiseFFT (paddedLength);
+        }
+    }
+
+    SpectrumAnalyser::SpectrumAnalyser (const Frames& framesToUse, double sampleRate, const Options& options)
+      : frames (&framesToUse),
+        inputLength (framesToUse.getFrameLength()),
+        paddedLength (framesToUse.getFFTLength()),
+        sampleRateByN (sampleRate / paddedLength),
+        window (framesToUse.getWindow()),
+        paddedInput (NULL),
+        spectrum (NULL),
+        singlePaddedInput (NULL),
+        numThreads (std::max (1, std::min (options.numThreads, framesToUse.getNumFrames()))),
+        blockFramesPerThread (1),
+        blockSpectra (NULL),
+        blockStart (0),
+        blockLength (0)
+    {
+        // spectra are passed straight through
+        if (frames->isSpectrum())
+        {
+            numThreads = 1;
+            return;
+        }
+
+        // a single thread works through the frames with one analyser using
+        // LibXtract's fft where it can, several share out blocks of frames
+        // between analysers with their own plans
+        for (int thread = 0; thread < numThreads; ++thread)
+        {
+            workers.push_back (std::unique_ptr<SpectrumAnalyser> (
+                new SpectrumAnalyser (inputLength, sampleRate, window, numThreads > 1, thread, paddedLength,
+                                      options.singlePrecision)));
+        }
+
+        if (numThreads > 1)
+        {
+            // the bytes taken by one frame for every thread
+            size_t roundBytes = (size_t) numThreads * paddedLength * sizeof (double);
+            blockFramesPerThread = (int) std::max ((size_t) 1, std::min ((size_t) maxFramesPerThread,
+                                                                         maxBlockBytes / roundBytes));
+            blockSpectra = getScratch (blockSpectraBuffer, numThreads * blockFramesPerThread * paddedLength);
+        }
+    }
+
+    int SpectrumAnalyser::getPaddedLength() const
+    {
+        return paddedLength;
+    }
+
+    double SpectrumAnalyser::getSampleRateByN() const
+    {
+        return sampleRateByN;
+    }
+
+    const double* SpectrumAnalyser::findSpectrum (const double* input)
+    {
+        if (frames != NULL)
+        {
+            return frames->isSpectrum() ? input : findBatchSpectrum (input);
+        }
+
+        findSpectrum (input, spectrum);
+        return spectrum;
+    }
+
+    const double* SpectrumAnalyser::findSpectrum (const float* input)
+    {
+        if (frames != NULL)
+        {
+            return findBatchSpectrum (input);
+        }
+
+        findSpectrum (input, spectrum);
+        return spectrum;
+    }
+
+    const double* SpectrumAnalyser::findSpectrum (int frame)
+    {
+        if (numThreads == 1)
+        {
+            if (frames->isSingle() && ! frames->isSpectrum())
+            {
+                return findSpectrum (frames->getSingleFrame (frame));
+            }
+
+            return findSpectrum (frames->getFrame (frame));
+        }
+
+        if (frame < blockStart || frame >= blockStart + blockLength)
+        {
+            findBlock (frame);
+        }
+
+        return blockSpectra + (frame - blockStart) * paddedLength;
+    }
+
+    template <typename T>
+    const double* SpectrumAnalyser::findBatchSpectrum (const T* input)
+    {
+        return workers [0]->findSpectrum (input);
+    }
+
+    const double* SpectrumAnalyser::findSpectrum (const double* ring, int start)
+    {
+        // the frame is unrolled from the ring as it is copied into the
+        // padding buffer, so it is still only copied once
+        copyIn (ring + start, 0, inputLength - start);
+        copyIn (ring, inputLength - start, start);
+        transform (spectrum);
+        return spectrum;
+    }
+
+    template <typename T>
+    void SpectrumAnalyser::findSpectrum (const T* input, double* result)
+    {
+        copyIn (input, 0, inputLength);
+        transform (result);
+    }
+
+    template <typename T>
+    void SpectrumAnalyser::copyIn (const T* input, int first, int length)
+    {
+        // the zero padding at the end of the buffer is never written to so
+        // only the input samples need copying in, converting them to the
+        // precision of the fft as they go
+        if (singleFFT)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                singlePaddedInput [first + i] = (window == NULL) ? input [i] : input [i] * window [first + i];
+            }
+
+            return;
+        }
+
+        if (window == NULL)
+        {
+            std::copy (input, input + length, paddedInput + first);
+        }
+        else
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                paddedInput [first + i] = input [i] * window [first + i];
+            }
+        }
+    }
+
+    void SpectrumAnalyser::transform (double* result)
+    {
+        if (singleFFT)
+        {
+            singleFFT->magnitudeSpectrum (singlePaddedInput, sampleRateByN, result);
+        }
+        else if (fft)
+        {
+            fft->magnitudeSpectrum (paddedInput, sampleRateByN, result);
+        }
+        else
+        {
+            double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+
+            // another analyser may have replanned the fft since we were created
+            initialiseFFT (paddedLength);
+            xtract_spectrum (paddedInput, paddedLength, argumentArray, result);
+        }
+    }
+
+    void SpectrumAnalyser::findBlock (int firstFrame)
+    {
+        blockStart = firstFrame;
+        blockLength = std::min (numThreads * blockFramesPerThread, frames->getNumFrames() - firstFrame);
+
+        parallelFor (blockLength, numThreads, [this] (int first, int last, int thread)
+        {
+            for (int i = first; i < last; ++i)
+            {
+                double* result = blockSpectra + i * paddedLength;
+
+                if (frames->isSingle())
+                {
+                    workers [thread]->findSpectrum (frames->getSingleFrame (blockStart + i), result);
+                }
+                else
+                {
+                    workers [thread]->findSpectrum (frames->getFrame (blockStart + i), result);
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_SPECTRUM_H
+#define XTRACT_OCTAVE_SPECTRUM_H
+
+#include "fft.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace XtractOctave
+{
+    class Frames;
+    struct Options;
+
+    // Finds the magnitude spectrum of a sequence of equal length frames.
+    //
+    // Each frame is zero padded so it is a power of 2 in length (or the
+    // length given by the frames' fftsize option) before its spectrum is
+    // found with xtract_spectrum, or with RealFFT for lengths LibXtract
+    // can't be relied on to handle. If a window is given (inputLength samples
+    // long) it is applied as the frame is copied into the padding buffer.
+    // The padding buffer and spectrum come from the scratch arena of the
+    // thread the analyser runs on, so they are only allocated the first
+    // time a length is seen in the session. Only one analyser should be
+    // used on a thread at a time.
+    //
+    // Frames can be single or double precision. In single precision mode
+    // the padding and fft are done with floats (half the memory traffic of
+    // doubles), only the magnitudes are widened to doubles for LibXtract.
+    //
+    // When a batch is analysed with more than one thread the spectra are
+    // found a block of frames at a time, with the frames in each block
+    // shared out between the threads. Each thread has its own fft plan and
+    // buffers, so LibXtract's global fft is not used at all.
+    class SpectrumAnalyser
+    {
+    public:
+        // Analyse frames one at a time. If privatePlan is true the analyser
+        // uses its own fft plan rather than LibXtract's, so it can be used
+        // off the main thread. thread picks the scratch arena to use,
+        // fftLength the padded length (0 for the next power of 2), and
+        // singlePrecision switches to a single precision fft.
+        SpectrumAnalyser (int inputLength, double sampleRate, const double* window = NULL,
+                          bool privatePlan = false, int thread = 0, int fftLength = 0,
+                          bool singlePrecision = false);
+
+        // Analyse a batch of frames with their window and fft length, and
+        // the number of threads and precision given in the options. If the
+        // frames are already spectra they are returned as they are.
+        SpectrumAnalyser (const Frames& frames, double sampleRate, const Options& options);
+
+        // the length of the fft, the spectrum returned is this long with the
+        // magnitudes in the first half and the frequencies in the second
+        int getPaddedLength() const;
+
+        double getSampleRateByN() const;
+
+        // find the spectrum of a frame inputLength samples long, the result
+        // is valid until the next call
+        const double* findSpectrum (const double* input);
+        const double* findSpectrum (const float* input);
+
+        // find the spectrum of a frame of the batch, the result is valid
+        // until the next call
+        const double* findSpectrum (int frame);
+
+        // find the spectrum of a frame held in a ring buffer inputLength
+        // samples long, with its first sample at start, the result is valid
+        // until the next call
+        const double* findSpectrum (const double* ring, int start);
+
+    private:
+        template <typename T>
+        void findSpectrum (const T* input, double* result);
+
+        // copy length samples of a frame into the padding buffer from its
+        // first sample on, applying the window
+        template <typename T>
+        void copyIn (const T* input, int first, int length);
+
+        // find the spectrum of the padding buffer
+        void transform (double* result);
+
+        template <typename T>
+        const double* findBatchSpectrum (const T* input);
+
+        void findBlock (int firstFrame);
+
+        const Frames* frames;
+        int inputLength;
+        int paddedLength;
+        double sampleRateByN;
+        const double* window;
+
+        double* paddedInput;
+        double* spectrum;
+
+        // only used when the analyser doesn't use LibXtract's fft
+        std::unique_ptr<RealFFT> fft;
+
+        // only used in single precision mode
+        float* singlePaddedInput;
+        std::unique_ptr<FloatRealFFT> singleFFT;
+
+        // only used when analysing a batch, one worker per thread
+        int numThreads;
+        int blockFramesPerThread;
+        std::vector<std::unique_ptr<SpectrumAnalyser> > workers;
+        double* blockSpectra;
+        int blockStart;
+        int blockLength;
+    };
+}
+
+#endif
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "thread_pool.h"
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        class ThreadPool
+        {
+        public:
+            ThreadPool()
+              : job (NULL),
+                nextTask (0),
+                numTasks (0),
+                tasksRemaining (0),
+                stopping (false)
+            {
+            }
+
+            ~ThreadPool()
+            {
+                stop();
+            }
+
+            // run job (task) for every task in [0, numTasksToRun), the
+            // calling thread runs task 0 itself
+            void run (int numTasksToRun, const std::function<void (int)>& jobToRun)
+            {
+                startThreads (numTasksToRun - 1);
+
+                {
+                    std::unique_lock<std::mutex> lock (mutex);
+                    job = &jobToRun;
+                    nextTask = 1;
+                    numTasks = numTasksToRun;
+                    tasksRemaining = numTasksToRun - 1;
+                    workerException = NULL;
+                }
+
+                workAvailable.notify_all();
+
+                // the workers still hold a pointer to the job, so wait for
+                // them even if our own task throws (an interrupt, say)
+                try
+                {
+                    jobToRun (0);
+                }
+                catch (...)
+                {
+                    waitForWorkers();
+                    throw;
+                }
+
+                // an exception thrown by a worker's task is passed on here,
+                // on the calling thread
+                std::exception_ptr exception = waitForWorkers();
+
+                if (exception)
+                {
+                    std::rethrow_exception (exception);
+                }
+            }
+
+            void stop()
+            {
+                {
+                    std::unique_lock<std::mutex> lock (mutex);
+                    stopping = true;
+                }
+
+                workAvailable.notify_all();
+
+                for (size_t i = 0; i < threads.size(); ++i)
+                {
+                    threads [i].join();
+                }
+
+                threads.clear();
+                stopping = false;
+            }
+
+        private:
+            void startThreads (int numThreads)
+            {
+                while ((int) threads.size() < numThreads)
+                {
+                    threads.push_back (std::thread (&ThreadPool::work, this));
+                }
+            }
+
+            // returns the first exception thrown by a worker's task, if any
+            std::exception_ptr waitForWorkers()
+            {
+                std::unique_lock<std::mutex> lock (mutex);
+                workDone.wait (lock, [this] { return tasksRemaining == 0; });
+                job = NULL;
+
+                std::exception_ptr exception = workerException;
+                workerException = NULL;
+                return exception;
+            }
+
+            void work()
+            {
+                std::unique_lock<std::mutex> lock (mutex);
+
+                while (true)
+                {
+                    workAvailable.wait (lock, [this] { return stopping || nextTask < numTasks; });
+
+                    if (stopping)
+                    {
+                        return;
+                    }
+
+                    int task = nextTask++;
+                    const std::function<void (int)>& jobToRun = *job;
+
+                    lock.unlock();
+
+                    // an exception can't leave the thread, so it is kept
+                    // for run to rethrow once every task has finished
+                    std::exception_ptr exception;
+
+                    try
+                    {
+                        jobToRun (task);
+                    }
+                    catch (...)
+                    {
+                        exception = std::current_exception();
+                    }
+
+                    lock.lock();
+
+                    if (exception && ! workerException)
+                    {
+                        workerException = exception;
+                    }
+
+                    if (--tasksRemaining == 0)
+                    {
+                        workDone.notify_all();
+                    }
+                }
+            }
+
+            std::vector<std::thread> threads;
+            std::mutex mutex;
+            std::condition_variable workAvailable;
+            std::condition_variable workDone;
+
+            const std::function<void (int)>* job;
+            std::exception_ptr workerException;
+            int nextTask;
+            int numTasks;
+            int tasksRemaining;
+            bool stopping;
+        };
+
+        ThreadPool threadPool;
+    }
+
+    void parallelFor (int numItems, int numThreads,
+                      const std::function<void (int first, int last, int thread)>& task)
+    {
+        if (numThreads > numItems)
+        {
+            numThreads = numItems;
+        }
+
+        if (numThreads <= 1)
+        {
+            if (numItems > 0)
+            {
+                task (0, numItems, 0);
+            }
+
+            return;
+        }
+
+        threadPool.run (numThreads, [&] (int thread)
+        {
+            int first = (long) numItems * thread / numThreads;
+            int last = (long) numItems * (thread + 1) / numThreads;
+            task (first, last, thread);
+        });
+    }
+
+    int getNumHardwareThreads()
+    {
+        int numThreads = std::thread::hardware_concurrency();
+        return (numThreads > 0) ? numThreads : 1;
+    }
+
+    void stopThreadPool()
+    {
+        threadPool.stop();
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_THREAD_POOL_H
+#define XTRACT_OCTAVE_THREAD_POOL_H
+
+#include <functional>
+
+namespace XtractOctave
+{
+    // Split the items [0, numItems) into numThreads contiguous chunks and
+    // call task (first, last, thread) for each chunk in parallel, blocking
+    // until they have all finished.
+    //
+    // Chunk t always covers the same items and is always given thread index
+    // t, so per thread resources can be indexed by it and results written
+    // into per item slots come out in the same order whatever the thread
+    // count. The calling thread works on the first chunk, the others are
+    // handed to a pool of worker threads which is kept for the session.
+    void parallelFor (int numItems, int numThreads,
+                      const std::function<void (int first, int last, int thread)>& task);
+
+    // The number of threads to use when the user asks for 0 (all of them).
+    int getNumHardwareThreads();
+
+    // Stop the pool's worker threads, they are started again when needed.
+    void stopThreadPool();
+}
+
+#endif
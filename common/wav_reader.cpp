@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "wav_reader.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        const int pcmFormat = 1;
+        const int floatFormat = 3;
+        const int extensibleFormat = 0xFFFE;
+
+        // pages are only handed back once this much has been read past
+        const size_t releaseLength = 1 << 20;
+
+        // WAV files are little endian whatever the machine
+        unsigned int readLittleEndian (const unsigned char* bytes, int numBytes)
+        {
+            unsigned int value = 0;
+
+            for (int i = numBytes - 1; i >= 0; --i)
+            {
+                value = (value << 8) | bytes [i];
+            }
+
+            return value;
+        }
+    }
+
+    WavReader::WavReader()
+      : mapping (MAP_FAILED),
+        mappingLength (0),
+        data (NULL),
+        length (0),
+        sampleRate (0),
+        numChannels (0),
+        bytesPerSample (0),
+        isFloat (false),
+        releasedTo (0)
+    {
+    }
+
+    WavReader::~WavReader()
+    {
+        if (mapping != MAP_FAILED)
+        {
+            munmap (mapping, mappingLength);
+        }
+    }
+
+    double WavReader::getSampleRate() const
+    {
+        return sampleRate;
+    }
+
+    int WavReader::getNumChannels() const
+    {
+        return numChannels;
+    }
+
+    long WavReader::getLength() const
+    {
+        return length;
+    }
+
+    double WavReader::readSample (const unsigned char* sample) const
+    {
+        if (isFloat)
+        {
+            // floats are stored as IEEE 754, which is all Octave runs on
+            if (bytesPerSample == 4)
+            {
+                unsigned int bits = readLittleEndian (sample, 4);
+                float value;
+                memcpy (&value, &bits, 4);
+                return value;
+            }
+
+            unsigned long long bits = readLittleEndian (sample, 4) | ((unsigned long long) readLittleEndian (sample + 4, 4) << 32);
+            double value;
+            memcpy (&value, &bits, 8);
+            return value;
+        }
+
+        // 8 bit samples are unsigned, the rest are signed
+        if (bytesPerSample == 1)
+        {
+            return (sample [0] - 128) / 128.0;
+        }
+
+        int numBits = 8 * bytesPerSample;
+        long long value = readLittleEndian (sample, bytesPerSample);
+
+        if (value >= (1LL << (numBits - 1)))
+        {
+            value -= (1LL << numBits);
+        }
+
+        return value / (double) (1LL << (numBits - 1));
+    }
+
+    void WavReader::read (long start, int numSamples, double* samples)
+    {
+        int frameBytes = numChannels * bytesPerSample;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            long position = start + i;
+
+            if (position < 0 || position >= length)
+            {
+                samples [i] = 0;
+                continue;
+            }
+
+            const unsigned char* frame = data + position * frameBytes;
+            double sum = 0;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                sum += readSample (frame + channel * bytesPerSample);
+            }
+
+            samples [i] = sum / numChannels;
+        }
+
+        // hand back the pages before this stretch, they won't be needed
+        // again unless an earlier stretch is asked for, when they are just
+        // read in from the file again
+        size_t offset = (data - (const unsigned char*) mapping) + std::max (0L, start) * frameBytes;
+
+        if (offset > releasedTo + releaseLength)
+        {
+            size_t pageSize = sysconf (_SC_PAGESIZE);
+            size_t releaseTo = offset / pageSize * pageSize;
+
+            madvise ((char*) mapping + releasedTo, releaseTo - releasedTo, MADV_DONTNEED);
+            releasedTo = releaseTo;
+        }
+    }
+
+    AudioReader* openWavFile (const std::string& path, std::string& problem)
+    {
+        int file = open (path.c_str(), O_RDONLY);
+
+        if (file < 0)
+        {
+            problem = "it can't be opened";
+            return NULL;
+        }
+
+        struct stat status;
+
+        if (fstat (file, &status) != 0 || status.st_size < 12)
+        {
+            close (file);
+            return NULL;
+        }
+
+        // the mapping holds on to the file, so it can be closed straight away
+        size_t fileLength = status.st_size;
+        void* mapping = mmap (NULL, fileLength, PROT_READ, MAP_PRIVATE, file, 0);
+        close (file);
+
+        if (mapping == MAP_FAILED)
+        {
+            problem = "it can't be mapped into memory";
+            return NULL;
+        }
+
+        WavReader* reader = new WavReader();
+        reader->mapping = mapping;
+        reader->mappingLength = fileLength;
+
+        const unsigned char* bytes = (const unsigned char*) mapping;
+
+        if (memcmp (bytes, "RIFF", 4) != 0 || memcmp (bytes + 8, "WAVE", 4) != 0)
+        {
+            delete reader;
+            return NULL;
+        }
+
+        madvise (mapping, fileLength, MADV_SEQUENTIAL);
+
+        // find the format and data chunks
+        int format = 0;
+        int bitsPerSample = 0;
+        size_t dataLength = 0;
+
+        for (size_t position = 12; position + 8 <= fileLength; )
+        {
+            const unsigned char* chunk = bytes + position;
+            size_t chunkLength = readLittleEndian (chunk + 4, 4);
+            size_t available = std::min (chunkLength, fileLength - position - 8);
+
+            if (memcmp (chunk, "fmt ", 4) == 0 && available >= 16)
+            {
+                format = readLittleEndian (chunk + 8, 2);
+                reader->numChannels = readLittleEndian (chunk + 10, 2);
+                reader->sampleRate = readLittleEndian (chunk + 12, 4);
+                bitsPerSample = readLittleEndian (chunk + 22, 2);
+
+                // the real format of an extensible file starts its sub format
+                if (format == extensibleFormat && available >= 40)
+                {
+                    format = readLittleEndian (chunk + 32, 2);
+                }
+            }
+            else if (memcmp (chunk, "data", 4) == 0)
+            {
+                reader->data = chunk + 8;
+                dataLength = available;
+                break;
+            }
+
+            // chunks are padded to an even length
+            position += 8 + chunkLength + (chunkLength % 2);
+        }
+
+        reader->bytesPerSample = bitsPerSample / 8;
+        reader->isFloat = (format == floatFormat);
+
+        bool isSupported = (format == pcmFormat && bitsPerSample >= 8 && bitsPerSample <= 32 && bitsPerSample % 8 == 0)
+                           || (format == floatFormat && (bitsPerSample == 32 || bitsPerSample == 64));
+
+        if (reader->data == NULL || reader->numChannels < 1 || ! isSupported)
+        {
+            problem = "it is a WAV file with a sample format which can't be read";
+            delete reader;
+            return NULL;
+        }
+
+        reader->length = dataLength / (reader->numChannels * reader->bytesPerSample);
+
+        return reader;
+    }
+}
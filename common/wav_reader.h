@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_WAV_READER_H
+#define XTRACT_OCTAVE_WAV_READER_H
+
+#include "audio_file.h"
+#include <cstddef>
+#include <string>
+
+namespace XtractOctave
+{
+    // Reads a WAV file through a memory map.
+    //
+    // 8, 16, 24 and 32 bit integer and 32 and 64 bit float samples are
+    // read, in plain or extensible WAV files. The samples are converted
+    // from the mapped file as they are read, and once a stretch of the file
+    // has been read past its pages are handed back to the system, so the
+    // memory used stays in proportion to the stretches read at a time
+    // rather than the length of the file.
+    class WavReader : public AudioReader
+    {
+    public:
+        ~WavReader();
+
+        double getSampleRate() const;
+        int getNumChannels() const;
+        long getLength() const;
+        void read (long start, int length, double* samples);
+
+    private:
+        friend AudioReader* openWavFile (const std::string& path, std::string& problem);
+
+        WavReader();
+
+        double readSample (const unsigned char* sample) const;
+
+        void* mapping;
+        size_t mappingLength;
+        const unsigned char* data;
+        long length;
+        double sampleRate;
+        int numChannels;
+        int bytesPerSample;
+        bool isFloat;
+
+        // everything before this has been handed back to the system
+        size_t releasedTo;
+    };
+
+    // the AudioFormat open function for WAV files
+    AudioReader* openWavFile (const std::string& path, std::string& problem);
+}
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include "window.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace XtractOctave
+{
+    namespace
+    {
+        struct WindowKey
+        {
+            std::string type;
+            double parameter;
+            int length;
+
+            bool operator< (const WindowKey& other) const
+            {
+                if (type != other.type) return type < other.type;
+                if (parameter != other.parameter) return parameter < other.parameter;
+                return length < other.length;
+            }
+        };
+
+        std::map<WindowKey, std::vector<double> > windowCache;
+
+        // the cache is shared between the threads of a batch
+        std::mutex windowCacheMutex;
+
+        // the zeroth order modified bessel function of the first kind
+        double besselI0 (double x)
+        {
+            double sum = 1;
+            double term = 1;
+
+            for (int k = 1; term > 1e-16 * sum; ++k)
+            {
+                term *= (x / (2 * k)) * (x / (2 * k));
+                sum += term;
+            }
+
+            return sum;
+        }
+
+        bool makeWindow (const std::string& type, double parameter, int length, std::vector<double>& window)
+        {
+            if (! (type == "hann" || type == "hamming" || type == "blackman" ||
+                   type == "blackman-harris" || type == "kaiser"))
+            {
+                return false;
+            }
+
+            window.resize (length);
+
+            // windows are symmetric, a single sample window is just 1
+            double denominator = (length > 1) ? length - 1 : 1;
+            double beta = parameter;
+
+            for (int n = 0; n < length; ++n)
+            {
+                double phase = 2 * M_PI * n / denominator;
+
+                if (type == "hann")
+                {
+                    window [n] = 0.5 - 0.5 * cos (phase);
+                }
+                else if (type == "hamming")
+                {
+                    window [n] = 0.54 - 0.46 * cos (phase);
+                }
+                else if (type == "blackman")
+                {
+                    window [n] = 0.42 - 0.5 * cos (phase) + 0.08 * cos (2 * phase);
+                }
+                else if (type == "blackman-harris")
+                {
+                    window [n] = 0.35875 - 0.48829 * cos (phase) + 0.14128 * cos (2 * phase) - 0.01168 * cos (3 * phase);
+                }
+                else if (type == "kaiser")
+                {
+                    double position = 2 * n / denominator - 1;
+                    window [n] = besselI0 (beta * sqrt (std::max (0.0, 1 - position * position))) / besselI0 (beta);
+                }
+            }
+
+            return true;
+        }
+    }
+
+    bool findWindow (const std::string& type, double parameter, int length, const double*& window)
+    {
+        window = NULL;
+
+        if (type == "rectangular")
+        {
+            return true;
+        }
+
+        // only the kaiser window has a parameter, beta is 8.6 if it isn't
+        // given
+        if (type != "kaiser")
+        {
+            parameter = 0;
+        }
+        else if (std::isnan (parameter))
+        {
+            parameter = 8.6;
+        }
+
+        WindowKey key = {type, parameter, length};
+        std::lock_guard<std::mutex> lock (windowCacheMutex);
+
+        std::map<WindowKey, std::vector<double> >::iterator cached = windowCache.find (key);
+
+        if (cached == windowCache.end())
+        {
+            std::vector<double> table;
+
+            if (! makeWindow (type, parameter, length, table))
+            {
+                return false;
+            }
+
+            cached = windowCache.insert (std::make_pair (key, table)).first;
+        }
+
+        window = cached->second.empty() ? NULL : &cached->second [0];
+        return true;
+    }
+
+    void clearWindowCache()
+    {
+        std::lock_guard<std::mutex> lock (windowCacheMutex);
+        windowCache.clear();
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifndef XTRACT_OCTAVE_WINDOW_H
+#define XTRACT_OCTAVE_WINDOW_H
+
+#include <string>
+
+namespace XtractOctave
+{
+    // Get a window function of the given type and length.
+    //
+    // The types recognised are "rectangular", "hann", "hamming",
+    // "blackman", "blackman-harris" (the four term version) and "kaiser",
+    // whose beta is given by parameter (NaN for the default of 8.6). Each
+    // table is built the first time a type and length are asked for and
+    // kept for the rest of the session, so it is only worked out once.
+    // window is set to NULL for a rectangular window, as nothing needs to
+    // be applied. Returns false if the type isn't one of these.
+    bool findWindow (const std::string& type, double parameter, int length, const double*& window);
+
+    // Free all the window tables which have been built.
+    void clearWindowCache();
+}
+
+#endif
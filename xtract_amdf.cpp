@@ -23,40 +23,83 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/difference_functions.h"
+#include "common/frames.h"
 
 DEFUN_DLD (xtract_amdf, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_amdf (@var{data})\n"
+"@deftypefnx {Function File} {} xtract_amdf (@var{data}, @var{maxlag})\n"
+"@deftypefnx {Function File} {} xtract_amdf (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the average magnitude difference function of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_amdf function.\n"
+"\n""@var{maxlag} is the longest lag, in samples, to find the amdf for, so @var{maxlag} + 1 values are returned for each frame. If no value is given every lag up to N - 1 is found, where N is the length of the input signal. Restricting the lags to the range of periods of interest saves most of the work for long frames.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a matrix is returned with the amdf of each frame in the corresponding column.\n"
+"\n"
+"The \"framesize\" and \"hopsize\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 1)
+    if (! ((numArgs > 0) && (numArgs < 3)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-        const double* inputData = input.data();
-
-        // find amdf
-        OCTAVE_LOCAL_BUFFER (double, amdf, inputLength);
-        xtract_amdf (inputData, inputLength, NULL, amdf);
-
-        // put into an output vector
-        RowVector output (inputLength);
-        int n = inputLength;
-        while (n--)
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+
+        if (frames.isSpectrum())
+        {
+            error ("xtract_amdf: DATA must be a signal rather than a spectrum");
+            return octave_value_list();
+        }
+
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
+
+        // get the number of lags
+        int numLags = inputLength;
+        if (numArgs == 2)
         {
-            output (n) = amdf [n];
+            int maxLag = args (1).int_value();
+
+            // make sure the maximum lag is within the correct range
+            if (! ((maxLag >= 0) && (maxLag < inputLength)))
+            {
+                octave_stdout << "MAXLAG must be at least 0 and less than the length of DATA.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+
+            numLags = maxLag + 1;
+        }
+
+        // find amdf, one column per frame
+        Matrix output (numLags, numFrames);
+        double* amdf = output.fortran_vec();
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            if (numLags == inputLength)
+            {
+                xtract_amdf (frames.getFrame (frame), inputLength, NULL, amdf + frame * numLags);
+            }
+            else
+            {
+                XtractOctave::findAMDF (frames.getFrame (frame), inputLength, numLags, amdf + frame * numLags);
+            }
         }
 
-        return octave_value (output);
+        return XtractOctave::packResults (output);
     }
 }
@@ -22,41 +22,81 @@
  */
 
 #include <octave/oct.h>
-#include <xtract/libxtract.h>
+#include "common/difference_functions.h"
+#include "common/frames.h"
 
 DEFUN_DLD (xtract_asdf, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_asdf (@var{data})\n"
+"@deftypefnx {Function File} {} xtract_asdf (@var{data}, @var{maxlag})\n"
+"@deftypefnx {Function File} {} xtract_asdf (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the average square difference function of the signal @var{data}.\n"
 "\n"
-"A wrapper for LibXtract\'s xtract_asdf function.\n"
+"Equivalent to LibXtract\'s xtract_asdf function.\n"
+"\n""@var{maxlag} is the longest lag, in samples, to find the asdf for, so @var{maxlag} + 1 values are returned for each frame. If no value is given every lag up to N - 1 is found, where N is the length of the input signal.\n"
+"\n"
+"The result is the same as xtract_asdf\'s but is found from the autocorrelation of the signal, through an fft when there are many lags, so it takes O(N log N) rather than O(N^2) time.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a matrix is returned with the asdf of each frame in the corresponding column.\n"
+"\n"
+"The \"framesize\" and \"hopsize\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 1)
+    if (! ((numArgs > 0) && (numArgs < 3)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-        const double* inputData = input.data();
-
-        // find asdf
-        OCTAVE_LOCAL_BUFFER (double, asdf, inputLength);
-        xtract_asdf (inputData, inputLength, NULL, asdf);
-
-        // put into an output vector
-        RowVector output (inputLength);
-        int n = inputLength;
-        while (n--)
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+
+        if (frames.isSpectrum())
+        {
+            error ("xtract_asdf: DATA must be a signal rather than a spectrum");
+            return octave_value_list();
+        }
+
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
+
+        // get the number of lags
+        int numLags = inputLength;
+        if (numArgs == 2)
         {
-            output (n) = asdf [n];
+            int maxLag = args (1).int_value();
+
+            // make sure the maximum lag is within the correct range
+            if (! ((maxLag >= 0) && (maxLag < inputLength)))
+            {
+                octave_stdout << "MAXLAG must be at least 0 and less than the length of DATA.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+
+            numLags = maxLag + 1;
+        }
+
+        // the autocorrelation is only found for the lags we need
+        XtractOctave::Autocorrelator autocorrelator (inputLength, numLags);
+
+        // find asdf, one column per frame
+        Matrix output (numLags, numFrames);
+        double* asdf = output.fortran_vec();
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            XtractOctave::findASDF (frames.getFrame (frame), inputLength, autocorrelator, asdf + frame * numLags);
         }
 
-        return octave_value (output);
+        return XtractOctave::packResults (output);
     }
 }
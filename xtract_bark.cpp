@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/features.h"
+#include <vector>
+
+DEFUN_DLD (xtract_bark, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {} xtract_bark (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_bark (@dots{}, @var{option}, @var{value}, @dots{})\n"
+"Calculate the bark coefficients, loudness and sharpness of the signal @var{data} with sample rate @var{fs} in a single pass.\n"
+"\n"
+"The result is a struct with the fields bark_coefficients (the 25 sums of the spectrum over each bark band, as LibXtract\'s xtract_bark_coefficients finds them), loudness and sharpness. The loudness and sharpness are found from the bark coefficients in the same way as xtract_loudness and xtract_sharpness find them, so the spectrum and bark coefficients of each frame are only found once.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and each field of the result has one column per frame.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\", \"precision\" and \"threads\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
+"@end deftypefn\n")
+{
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
+    // make sure the correct amount of arguments have been passed
+    if (numArgs != 2)
+    {
+        print_usage();
+        return octave_value_list();
+    }
+    else
+    {
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
+
+        // get the sample rate
+        double sampleRate = args (1).double_value();
+
+        // the bark domain features, all found from the same bark coefficients
+        const char* names [] = {"bark_coefficients", "loudness", "sharpness"};
+        std::vector<const XtractOctave::Feature*> features;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            features.push_back (XtractOctave::findFeature (names [i]));
+        }
+
+        XtractOctave::FrameParameter f0 (octave_value (0), numFrames);
+        std::vector<Matrix> results = XtractOctave::extractFeatures (frames, sampleRate, options, features, f0);
+
+        // put the results into a struct
+        octave_scalar_map output;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            output.assign (names [i], XtractOctave::packResults (results [i]));
+        }
+
+        return octave_value (output);
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include "common/bark.h"
+#include "common/fft_cache.h"
+#include "common/mel_filters.h"
+#include "common/scratch.h"
+#include "common/thread_pool.h"
+#include "common/window.h"
+
+DEFUN_DLD (xtract_clear_cache, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {} xtract_clear_cache ()\n"
+"Free the fft plans, mel filter banks, bark band limits, window tables, scratch buffers and worker threads which are kept between calls to the XtractOctave functions.\n"
+"\n"
+"The spectral functions only plan a new fft when they are given a signal whose padded length differs from the previous one, xtract_mfcc only builds each mel filter bank once and the bark band limits and window tables are only found once for each length. The buffers used to pad the frames and hold their spectra only grow. The threads started by the \"threads\" option wait for the next batch. These are kept for the rest of the Octave session unless this function is called.\n"
+"@end deftypefn\n")
+{
+    // make sure the correct amount of arguments have been passed
+    if (args.length() != 0)
+    {
+        print_usage();
+        return octave_value_list();
+    }
+    else
+    {
+        XtractOctave::clearFFTCache();
+        XtractOctave::clearMelFilterCache();
+        XtractOctave::clearBarkBandCache();
+        XtractOctave::clearWindowCache();
+        XtractOctave::clearScratch();
+        XtractOctave::stopThreadPool();
+
+        return octave_value_list();
+    }
+}
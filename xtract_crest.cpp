@@ -23,66 +23,67 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_crest, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_crest (@var{data})\n"
+"@deftypefnx {Function File} {} xtract_crest (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the spectral crest of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_crest function.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the crest of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 1)
+    if (numArgs != 1)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, 0, options);
+        int paddedLength = analyser.getPaddedLength();
 
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
         {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
+            OCTAVE_QUIT;
 
-        double argumentArray [4] = {0, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+            // find maximum magnitude in spectrum
+            double magnitudeMax = 0;
+            xtract_highest_value (spectrum, paddedLength / 2, NULL, &magnitudeMax);
 
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+            // find mean magnitude of spectrum
+            double magnitudeMean = 0;
+            xtract_mean (spectrum, paddedLength / 2, NULL, &magnitudeMean);
 
-        // find maximum magnitude in spectrum
-        double magnitudeMax = 0;
-        xtract_highest_value (spectrum, paddedLength / 2, NULL, &magnitudeMax);
+            // find the spectral crest
+            double crest = 0;
+            double argumentArray [2] = {magnitudeMax, magnitudeMean};
+            xtract_crest (NULL, 0, argumentArray, &crest);
 
-        // find mean magnitude of spectrum
-        double magnitudeMean = 0;
-        xtract_mean (spectrum, paddedLength / 2, NULL, &magnitudeMean);
-        
-        // find the spectral slope
-        double crest = 0;
-        argumentArray [0] = magnitudeMax;
-        argumentArray [1] = magnitudeMean;
-        xtract_crest (NULL, 0, argumentArray, &crest);
+            output (frame) = crest;
+        }
 
-        return octave_value (crest);
+        return octave_value (output);
     }
 }
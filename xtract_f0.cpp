@@ -23,75 +23,72 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/f0_tracker.h"
+#include "common/frames.h"
+#include "common/scratch.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_f0, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_f0 (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_f0 (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Estimate the fundamental frequency of the signal @var{data} with sample rate @var{fs}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_failsafe_f0 function.\n"
 "It will try and use xtract_f0 first.\n "
 "If that fails it will return the frequency of the lowest partial in the spectrum.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the fundamental frequency of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\" and \"fftsize\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 2)
+    if (numArgs != 2)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-        const double* inputData = input.data();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+
+        if (frames.isSpectrum())
+        {
+            error ("xtract_f0: DATA must be a signal rather than a spectrum");
+            return octave_value_list();
+        }
+
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
 
         // get the sample rate
         double sampleRate = args (1).double_value();
 
-        // find f0
-        double f0 = 0;
-        int firstExtractionResult = xtract_f0(inputData, inputLength, &sampleRate, &f0);
+        // set up the fft for the length of the frames in case we need it
+        XtractOctave::SpectrumAnalyser analyser (inputLength, sampleRate, frames.getWindow(), false, 0, frames.getFFTLength());
+        int paddedLength = analyser.getPaddedLength();
 
-        // if xtract_f0 fails we find the lowest spectral peak (a la xtract_failsafe_f0)
-        if (firstExtractionResult == XTRACT_NO_RESULT)
-        {
-            // zero pad the input so it is a power of 2 in length
-            int paddedLength = pow (2, ceil (log2 (inputLength)));
-            OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-            for (int i = 0; i < paddedLength; ++i)
-            {
-                if (i < inputLength)
-                {
-                    paddedInput [i] = input (i);
-                }
-                else
-                {
-                    paddedInput [i] = 0;
-                }
-            }
+        // get scratch memory for the peak finding algorithms
+        double* peaks = XtractOctave::getScratch (XtractOctave::peaksBuffer, paddedLength);
 
-            double sampleRateByN = sampleRate / paddedLength;
-            double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        RowVector output (numFrames);
 
-            // assign memory for the output of the xtract_spectrum function
-            OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
 
-            // initialise and run the fft
-            xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-            xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+            // find f0, falling back on the lowest spectral peak (a la xtract_failsafe_f0)
+            double f0 = XtractOctave::findF0 (frames.getFrame (frame), inputLength, sampleRate, analyser, peaks);
 
-            // find spectral peaks
-            OCTAVE_LOCAL_BUFFER (double, peaks, paddedLength);
-            argumentArray [1] = 10;
-            xtract_peak_spectrum (spectrum, paddedLength / 2, argumentArray, peaks);
-            
-            // find lowest frequency peak
-            argumentArray [0] = 0;
-            xtract_lowest_value (peaks + (paddedLength / 2), paddedLength / 2, argumentArray, &f0);
+            output (frame) = f0;
         }
 
-        return octave_value (f0);
+        return octave_value (output);
     }
 }
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include "common/f0_tracker.h"
+#include <string>
+#include <vector>
+
+DEFUN_DLD (xtract_f0_tracker, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {@var{handle} =} xtract_f0_tracker (\"create\", @var{fs}, @var{framesize})\n"
+"@deftypefnx {Function File} {@var{handle} =} xtract_f0_tracker (\"create\", @var{fs}, @var{framesize}, @var{hopsize})\n"
+"@deftypefnx {Function File} {@var{handle} =} xtract_f0_tracker (\"create\", @var{fs}, @var{framesize}, @var{hopsize}, @var{method})\n"
+"@deftypefnx {Function File} {@var{f0} =} xtract_f0_tracker (\"process\", @var{handle}, @var{data})\n"
+"@deftypefnx {Function File} {} xtract_f0_tracker (\"reset\", @var{handle})\n"
+"@deftypefnx {Function File} {} xtract_f0_tracker (\"destroy\", @var{handle})\n"
+"Track the fundamental frequency of a signal which is passed in as a series of chunks.\n"
+"\n"
+"\"create\" returns the handle of a new tracker for a signal with sample rate @var{fs}, which is split into frames @var{framesize} samples long starting @var{hopsize} samples apart. If no @var{hopsize} is given the frames don't overlap.\n"
+"\n"
+"@var{method} is either \"wavelet\" (the default) to use LibXtract\'s xtract_wavelet_f0, or \"f0\" to find the f0 of each frame as xtract_f0 does. The wavelet tracker\'s state is carried from one frame to the next rather than being reset for each frame as xtract_wavelet_f0 does. LibXtract only has room for one wavelet state, so if several trackers are used in turn each one starts afresh when it gets the state back.\n"
+"\n"
+"\"process\" passes the next @var{data} samples of the signal (a vector of any length) to a tracker and returns a row vector with the f0 of each frame they complete, which may be empty. Samples which don't yet make up a whole frame are kept until the next call, so any length of signal can be tracked with memory for a single frame.\n"
+"\n"
+"\"reset\" forgets any samples kept by a tracker and its wavelet state, ready for a new signal. \"destroy\" frees a tracker, its handle can't be used again.\n"
+"@end deftypefn\n")
+{
+    int numArgs = args.length();
+
+    // make sure the correct amount of arguments have been passed
+    if (numArgs < 2 || ! args (0).is_string())
+    {
+        print_usage();
+        return octave_value_list();
+    }
+
+    std::string action = args (0).string_value();
+    XtractOctave::HandleRegistry<XtractOctave::F0Tracker>& trackers = XtractOctave::getF0Trackers();
+
+    if (action == "create")
+    {
+        if (! ((numArgs > 2) && (numArgs < 6)))
+        {
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get the sample rate
+        double sampleRate = args (1).double_value();
+
+        // get the frame and hop sizes
+        int frameSize = args (2).int_value();
+        int hopSize = frameSize;
+
+        if (numArgs > 3)
+        {
+            hopSize = args (3).int_value();
+        }
+
+        if (frameSize < 1 || hopSize < 1)
+        {
+            octave_stdout << "FRAMESIZE and HOPSIZE must be at least 1.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get the method
+        XtractOctave::F0Tracker::Method method = XtractOctave::F0Tracker::waveletMethod;
+
+        if (numArgs == 5)
+        {
+            std::string methodName = args (4).string_value();
+
+            if (methodName == "wavelet")
+            {
+                method = XtractOctave::F0Tracker::waveletMethod;
+            }
+            else if (methodName == "f0")
+            {
+                method = XtractOctave::F0Tracker::spectralMethod;
+            }
+            else
+            {
+                octave_stdout << "METHOD must be either \"wavelet\" or \"f0\".\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
+
+        int handle = trackers.add (new XtractOctave::F0Tracker (sampleRate, frameSize, hopSize, method));
+
+        return octave_value (handle);
+    }
+
+    // all the other actions need a tracker
+    int handle = args (1).int_value();
+    XtractOctave::F0Tracker* tracker = trackers.get (handle);
+
+    if (tracker == NULL)
+    {
+        error ("xtract_f0_tracker: there is no tracker with handle %d", handle);
+        return octave_value_list();
+    }
+
+    if (action == "process")
+    {
+        if (numArgs != 3)
+        {
+            print_usage();
+            return octave_value_list();
+        }
+
+        // the samples are read straight from the argument
+        NDArray data = args (2).array_value();
+
+        if (! (data.isempty() || data.rows() == 1 || data.columns() == 1))
+        {
+            octave_stdout << "DATA must be a vector.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        std::vector<double> f0s;
+        tracker->process (data.data(), data.numel(), f0s);
+
+        RowVector output (f0s.size());
+
+        for (size_t frame = 0; frame < f0s.size(); ++frame)
+        {
+            output (frame) = f0s [frame];
+        }
+
+        return octave_value (output);
+    }
+    else if (action == "reset" && numArgs == 2)
+    {
+        tracker->reset();
+        return octave_value_list();
+    }
+    else if (action == "destroy" && numArgs == 2)
+    {
+        trackers.remove (handle);
+        return octave_value_list();
+    }
+    else
+    {
+        print_usage();
+        return octave_value_list();
+    }
+}
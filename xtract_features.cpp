@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/features.h"
+#include "common/feature_file.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+DEFUN_DLD (xtract_features, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {} xtract_features (@var{data}, @var{fs}, @var{features})\n"
+"@deftypefnx {Function File} {} xtract_features (@var{data}, @var{fs}, @var{features}, @var{f0})\n"
+"@deftypefnx {Function File} {} xtract_features (@var{data}, @var{fs}, @var{features}, @var{f0}, @var{threshold})\n"
+"@deftypefnx {Function File} {} xtract_features (@dots{}, @var{option}, @var{value}, @dots{})\n"
+"Calculate several features of the signal @var{data} with sample rate @var{fs} in a single pass.\n"
+"\n"
+"@var{features} is a cell array of feature names (or a single name). The result is a struct with a field for each of the requested features.\n"
+"\n"
+"The spectrum, spectral mean and variance, peak spectrum, harmonic spectrum and bark coefficients are found at most once per frame and shared between all the features which need them. Each feature is calculated in the same way as the function of the same name with the xtract_ prefix.\n"
+"\n"
+"The following features are recognised:\n"
+"\n"
+"spectral_centroid, spread, spectral_variance, spectral_standard_deviation, spectral_skewness, spectral_kurtosis, flatness, tonality, rolloff, spectral_slope, power, crest, smoothness, sharpness, irregularity_k, irregularity_j, loudness, bark_coefficients, hps, mfcc, noisiness, odd_even_ratio, tristimulus_1, tristimulus_2, tristimulus_3, tristimulus, spectral_inharmonicity, zcr\n"
+"\n"
+"tristimulus gives all three orders at once, one row per order.\n"
+"\n"
+"The rolloff is found with a threshold of 85%.\n"
+"\n"
+"@var{f0} is the fundamental frequency of the signal. It is needed for noisiness, odd_even_ratio and spectral_inharmonicity. If it is given the tristimulus is found from the harmonics only, otherwise all the spectral partials are used.\n"
+"\n"
+"@var{threshold} is the threshold used when finding the harmonic partials. It takes a value between 0 and 1 inclusive. If no value is given this will be set to 0.2.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and each field of the result has one column per frame. In this case @var{f0} can either be a scalar, or a vector giving the fundamental frequency of each frame.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\", \"precision\", \"threads\", \"output\", \"peakthreshold\" and \"maxpeaks\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
+"@seealso{xtract_read_features, xtract_file_features}\n"
+"@end deftypefn\n")
+{
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
+    // make sure the correct amount of arguments have been passed
+    if (! ((numArgs > 2) && (numArgs < 6)))
+    {
+        print_usage();
+        return octave_value_list();
+    }
+    else
+    {
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
+
+        // get the sample rate
+        double sampleRate = args (1).double_value();
+
+        // get the features to find
+        if (! (args (2).is_string() || args (2).iscellstr()))
+        {
+            octave_stdout << "FEATURES must be a string or a cell array of strings.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        string_vector names = args (2).string_vector_value();
+        std::vector<const XtractOctave::Feature*> features;
+        bool needF0 = false;
+
+        for (int i = 0; i < names.numel(); ++i)
+        {
+            const XtractOctave::Feature* feature = XtractOctave::findFeature (names [i]);
+
+            if (feature == NULL)
+            {
+                error ("xtract_features: unknown feature \"%s\"", names [i].c_str());
+                return octave_value_list();
+            }
+
+            if (feature->needsSignal && frames.isSpectrum())
+            {
+                error ("xtract_features: %s can't be found from a spectrum", names [i].c_str());
+                return octave_value_list();
+            }
+
+            needF0 = needF0 || feature->needsF0;
+            features.push_back (feature);
+        }
+
+        // get f0
+        if (needF0 && numArgs < 4)
+        {
+            octave_stdout << "F0 must be given to find noisiness, odd_even_ratio or spectral_inharmonicity.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        XtractOctave::FrameParameter f0 (numArgs > 3 ? args (3) : octave_value (0), numFrames);
+
+        if (! f0.isValid())
+        {
+            octave_stdout << "F0 must be a scalar or have one element per frame.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get threshold
+        double threshold = 0.2;
+        if (numArgs == 5)
+        {
+            threshold = args (4).double_value();
+
+            // make sure threshold is within the correct range
+            if (! ((threshold >= 0) && (threshold <=1)))
+            {
+                octave_stdout << "THRESHOLD must be between 0 and 1.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
+
+        int numFeatures = features.size();
+
+        // write the results to a feature file if asked to, each block of
+        // frames goes into the file as it is found
+        if (! options.output.empty())
+        {
+            std::vector<std::string> featureNames;
+            std::vector<int> featureLengths;
+
+            for (int i = 0; i < numFeatures; ++i)
+            {
+                featureNames.push_back (features [i]->name);
+                featureLengths.push_back (features [i]->length);
+            }
+
+            double frameRate = (options.frameSize > 0) ? sampleRate / options.hopSize : 0;
+            std::string problem;
+            std::unique_ptr<XtractOctave::FeatureFile> file (XtractOctave::FeatureFile::create (
+                options.output, featureNames, featureLengths, frameRate, numFrames, options.singlePrecision, problem));
+
+            if (! file)
+            {
+                error ("xtract_features: %s can't be written, %s", options.output.c_str(), problem.c_str());
+                return octave_value_list();
+            }
+
+            XtractOctave::extractFeatures (frames, sampleRate, options, features, f0, threshold, file.get());
+            return octave_value_list();
+        }
+
+        // find all the features in one pass
+        std::vector<Matrix> results = XtractOctave::extractFeatures (frames, sampleRate, options, features, f0, threshold);
+
+        // put the results into a struct
+        octave_scalar_map output;
+
+        for (int i = 0; i < numFeatures; ++i)
+        {
+            output.assign (features [i]->name, XtractOctave::packResults (results [i]));
+        }
+
+        return octave_value (output);
+    }
+}
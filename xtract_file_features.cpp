@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include "common/audio_file.h"
+#include "common/feature_file.h"
+#include "common/frames.h"
+#include "common/features.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+DEFUN_DLD (xtract_file_features, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {[@var{result}, @var{fs}] =} xtract_file_features (@var{filename}, @var{features}, \"framesize\", @var{framesize}, @dots{})\n"
+"@deftypefnx {Function File} {[@var{result}, @var{fs}] =} xtract_file_features (@var{filename}, @var{features}, @var{f0}, \"framesize\", @var{framesize}, @dots{})\n"
+"@deftypefnx {Function File} {[@var{result}, @var{fs}] =} xtract_file_features (@var{filename}, @var{features}, @var{f0}, @var{threshold}, \"framesize\", @var{framesize}, @dots{})\n"
+"@deftypefnx {Function File} {@var{fs} =} xtract_file_features (@dots{}, \"output\", @var{outputfile}, @dots{})\n"
+"Calculate several features of every frame of the audio file @var{filename} without loading the whole file.\n"
+"\n"
+"The file is read a block of frames at a time and each block is analysed as xtract_features would analyse it, so only a block of the signal is ever held in memory however long the file is. The channels of the file are mixed down to one. WAV files are read (through a memory map) with 8, 16, 24 or 32 bit integer or 32 or 64 bit float samples.\n"
+"\n"
+"@var{features}, @var{f0} and @var{threshold} are as for xtract_features, @var{f0} can either be a scalar or have one element per frame. The \"framesize\" option must be given, and the other options work as they do for xtract_features apart from \"input\" and \"stream\". The result is a struct with a field for each of the requested features with one column per frame, and @var{fs} is the sample rate of the file.\n"
+"\n"
+"With the \"output\" option the results are written a block at a time straight into the feature file @var{outputfile} (see xtract_read_features) instead, so neither the signal nor the results are ever held in memory, and only @var{fs} is returned. The values are written in single precision if \"precision\" is \"single\".\n"
+"@end deftypefn\n")
+{
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
+    // make sure the correct amount of arguments have been passed
+    if (! ((numArgs > 1) && (numArgs < 5)))
+    {
+        print_usage();
+        return octave_value_list();
+    }
+    else
+    {
+        if (options.frameSize == 0)
+        {
+            error ("xtract_file_features: framesize must be given");
+            return octave_value_list();
+        }
+
+        if (options.input != "signal" || options.stream != 0)
+        {
+            error ("xtract_file_features: the signal is always read from the file");
+            return octave_value_list();
+        }
+
+        // open the file
+        if (! args (0).is_string())
+        {
+            octave_stdout << "FILENAME must be a string.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        std::string path = args (0).string_value();
+        std::string problem;
+        std::unique_ptr<XtractOctave::AudioReader> reader (XtractOctave::openAudioFile (path, problem));
+
+        if (! reader)
+        {
+            error ("xtract_file_features: %s can't be read, %s", path.c_str(), problem.c_str());
+            return octave_value_list();
+        }
+
+        double sampleRate = reader->getSampleRate();
+        long length = reader->getLength();
+        long numFileFrames = (length < options.frameSize) ? 0 : 1 + (length - options.frameSize) / options.hopSize;
+
+        if (numFileFrames > std::numeric_limits<int>::max())
+        {
+            error ("xtract_file_features: %s has too many frames, use a larger hopsize", path.c_str());
+            return octave_value_list();
+        }
+
+        int numFrames = numFileFrames;
+
+        // get the features to find
+        if (! (args (1).is_string() || args (1).iscellstr()))
+        {
+            octave_stdout << "FEATURES must be a string or a cell array of strings.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        string_vector names = args (1).string_vector_value();
+        std::vector<const XtractOctave::Feature*> features;
+        bool needF0 = false;
+
+        for (int i = 0; i < names.numel(); ++i)
+        {
+            const XtractOctave::Feature* feature = XtractOctave::findFeature (names [i]);
+
+            if (feature == NULL)
+            {
+                error ("xtract_file_features: unknown feature \"%s\"", names [i].c_str());
+                return octave_value_list();
+            }
+
+            needF0 = needF0 || feature->needsF0;
+            features.push_back (feature);
+        }
+
+        // get f0
+        if (needF0 && numArgs < 3)
+        {
+            octave_stdout << "F0 must be given to find noisiness, odd_even_ratio or spectral_inharmonicity.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        NDArray f0 = (numArgs > 2) ? args (2).array_value() : NDArray (dim_vector (1, 1), 0);
+
+        if (! (f0.numel() == 1 || f0.numel() == numFrames))
+        {
+            octave_stdout << "F0 must be a scalar or have one element per frame.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get threshold
+        double threshold = 0.2;
+        if (numArgs == 4)
+        {
+            threshold = args (3).double_value();
+
+            // make sure threshold is within the correct range
+            if (! ((threshold >= 0) && (threshold <=1)))
+            {
+                octave_stdout << "THRESHOLD must be between 0 and 1.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
+
+        // assign memory for the results, one column per frame for each
+        // feature, or map the file they are to be written to
+        int numFeatures = features.size();
+        std::vector<Matrix> results;
+        std::unique_ptr<XtractOctave::FeatureFile> file;
+
+        if (options.output.empty())
+        {
+            for (int i = 0; i < numFeatures; ++i)
+            {
+                results.push_back (Matrix (features [i]->length, numFrames));
+            }
+        }
+        else
+        {
+            std::vector<std::string> featureNames;
+            std::vector<int> featureLengths;
+
+            for (int i = 0; i < numFeatures; ++i)
+            {
+                featureNames.push_back (features [i]->name);
+                featureLengths.push_back (features [i]->length);
+            }
+
+            file.reset (XtractOctave::FeatureFile::create (options.output, featureNames, featureLengths,
+                                                           sampleRate / options.hopSize, numFrames,
+                                                           options.singlePrecision, problem));
+
+            if (! file)
+            {
+                error ("xtract_file_features: %s can't be written, %s", options.output.c_str(), problem.c_str());
+                return octave_value_list();
+            }
+        }
+
+        // work through the file a block of frames at a time, each block
+        // holds just the samples its frames need
+        int blockLength = std::max (1, options.numThreads) * 64;
+
+        for (int blockStart = 0; blockStart < numFrames; blockStart += blockLength)
+        {
+            OCTAVE_QUIT;
+
+            int numBlockFrames = std::min (blockLength, numFrames - blockStart);
+            int numSamples = (numBlockFrames - 1) * options.hopSize + options.frameSize;
+
+            NDArray block (dim_vector (numSamples, 1));
+            reader->read ((long) blockStart * options.hopSize, numSamples, block.fortran_vec());
+
+            XtractOctave::Frames frames (octave_value (block), options);
+
+            NDArray blockF0 = f0;
+
+            if (f0.numel() > 1)
+            {
+                blockF0 = NDArray (dim_vector (numBlockFrames, 1));
+                std::copy (f0.data() + blockStart, f0.data() + blockStart + numBlockFrames, blockF0.fortran_vec());
+            }
+
+            XtractOctave::FrameParameter frameF0 (octave_value (blockF0), numBlockFrames);
+
+            std::vector<Matrix> blockResults = XtractOctave::extractFeatures (frames, sampleRate, options, features,
+                                                                             frameF0, threshold);
+
+            for (int i = 0; i < numFeatures; ++i)
+            {
+                if (file)
+                {
+                    file->write (i, blockStart, numBlockFrames, blockResults [i].data());
+                    continue;
+                }
+
+                int featureLength = features [i]->length;
+                std::copy (blockResults [i].data(), blockResults [i].data() + featureLength * numBlockFrames,
+                           results [i].fortran_vec() + (long) blockStart * featureLength);
+            }
+        }
+
+        // the results are already in the file
+        if (file)
+        {
+            return octave_value (sampleRate);
+        }
+
+        // put the results into a struct
+        octave_scalar_map output;
+
+        for (int i = 0; i < numFeatures; ++i)
+        {
+            output.assign (features [i]->name, XtractOctave::packResults (results [i]));
+        }
+
+        octave_value_list outputs;
+        outputs (0) = octave_value (output);
+        outputs (1) = octave_value (sampleRate);
+
+        return outputs;
+    }
+}
@@ -23,30 +23,42 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_flatness, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_flatness (@var{data})\n"
 "@deftypefnx {Function File} {} xtract_flatness (@var{data}, @var{db})\n"
+"@deftypefnx {Function File} {} xtract_flatness (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the spectral flatness of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_flatness function.\n"
 "For now only short lengths of input data (<= 128) should be used. I will endeavour to fix this at some point.\n"
 "\n"
-"@var{db} is an optional boolean argument to select whether the output is given in decibels or not."
+"@var{db} is an optional boolean argument to select whether the output is given in decibels or not.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the flatness of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (! ((args.length() > 0) && (args.length() < 3)))
+    if (! ((numArgs > 0) && (numArgs < 3)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
 
         // warn about too long an input vector
         if (inputLength > 128)
@@ -54,39 +66,9 @@ DEFUN_DLD (xtract_flatness, args, nargout,
             warning ("This function has serious issue with long input vectors. Try to keep your input vector length at or below 128. If not you are likely to get exceedingly inaccurate values.");
         }
 
-
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
-
-        // zero pad the input so it is a flatness of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
-        {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
-
-        double argumentArray [4] = {0, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
-
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
-
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
-
-        // find the spectral flatness
-        double spectralFlatness = 0;
-        xtract_flatness (spectrum, paddedLength / 2, NULL, &spectralFlatness);
-
         // return dB or not
         double db = 0;
-        if (args.length() == 2)
+        if (numArgs == 2)
         {
             db = args (1).double_value();
         }
@@ -95,16 +77,36 @@ DEFUN_DLD (xtract_flatness, args, nargout,
             db = false;
         }
 
-        if (db)
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, 0, options);
+        int paddedLength = analyser.getPaddedLength();
+
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
         {
-            if (spectralFlatness <= 0)
+            OCTAVE_QUIT;
+
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            // find the spectral flatness
+            double spectralFlatness = 0;
+            xtract_flatness (spectrum, paddedLength / 2, NULL, &spectralFlatness);
+
+            if (db)
             {
-                spectralFlatness = 2e-42;
+                if (spectralFlatness <= 0)
+                {
+                    spectralFlatness = 2e-42;
+                }
+
+                spectralFlatness = 10 * log10 (spectralFlatness);
             }
 
-            spectralFlatness = 10 * log10 (spectralFlatness);
+            output (frame) = spectralFlatness;
         }
 
-        return octave_value (spectralFlatness);
+        return octave_value (output);
     }
 }
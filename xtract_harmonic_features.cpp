@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/features.h"
+#include <vector>
+
+DEFUN_DLD (xtract_harmonic_features, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {} xtract_harmonic_features (@var{data}, @var{fs}, @var{f0})\n"
+"@deftypefnx {Function File} {} xtract_harmonic_features (@var{data}, @var{fs}, @var{f0}, @var{threshold})\n"
+"@deftypefnx {Function File} {} xtract_harmonic_features (@dots{}, @var{option}, @var{value}, @dots{})\n"
+"Calculate all the harmonic features of the signal @var{data} with sample rate @var{fs} and fundamental frequency @var{f0} in a single pass.\n"
+"\n"
+"The result is a struct with the fields noisiness, odd_even_ratio, tristimulus and spectral_inharmonicity. Each is found in the same way as the function of the same name with the xtract_ prefix, tristimulus has a row for each of the three orders and is found from the harmonics. The spectrum, peak spectrum and harmonic spectrum of each frame are only found once and shared between all of them, so this is much faster than calling each of the functions in turn.\n"
+"\n"
+"@var{threshold} is the threshold used when finding the harmonic partials. It takes a value between 0 and 1 inclusive. If no value is given this will be set to 0.2.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and each field of the result has one column per frame. In this case @var{f0} can either be a scalar, or a vector giving the fundamental frequency of each frame.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\", \"precision\", \"threads\", \"peakthreshold\" and \"maxpeaks\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
+"@end deftypefn\n")
+{
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
+    // make sure the correct amount of arguments have been passed
+    if (! ((numArgs > 2) && (numArgs < 5)))
+    {
+        print_usage();
+        return octave_value_list();
+    }
+    else
+    {
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
+
+        // get the sample rate
+        double sampleRate = args (1).double_value();
+
+        // get f0
+        XtractOctave::FrameParameter f0 (args (2), numFrames);
+
+        if (! f0.isValid())
+        {
+            octave_stdout << "F0 must be a scalar or have one element per frame.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get threshold
+        double threshold = 0.2;
+        if (numArgs == 4)
+        {
+            threshold = args (3).double_value();
+
+            // make sure threshold is within the correct range
+            if (! ((threshold >= 0) && (threshold <=1)))
+            {
+                octave_stdout << "THRESHOLD must be between 0 and 1.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
+
+        // the harmonic features, all found from the same peaks and harmonics
+        const char* names [] = {"noisiness", "odd_even_ratio", "tristimulus", "spectral_inharmonicity"};
+        std::vector<const XtractOctave::Feature*> features;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            features.push_back (XtractOctave::findFeature (names [i]));
+        }
+
+        std::vector<Matrix> results = XtractOctave::extractFeatures (frames, sampleRate, options, features, f0, threshold);
+
+        // put the results into a struct
+        octave_scalar_map output;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            output.assign (names [i], XtractOctave::packResults (results [i]));
+        }
+
+        return octave_value (output);
+    }
+}
@@ -23,60 +23,61 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_hps, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_hps (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_hps (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the fundamental frequency of the signal @var{data}, with sample rate @var{fs}, using the harmonic product spectrum techinque.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_hps function.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the fundamental frequency of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 2)
+    if (numArgs != 2)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
-
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
-        {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
         // get sample rate
         double fs = args (1).double_value();
-        double sampleRateByN = fs / paddedLength;
 
-        double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, fs, options);
+        int paddedLength = analyser.getPaddedLength();
+
+        RowVector output (numFrames);
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
 
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
 
-        // find f0
-        double hps = 0;
-        int test = xtract_hps (spectrum, paddedLength, &fs, &hps);
+            // find f0
+            double hps = 0;
+            xtract_hps (spectrum, paddedLength, &fs, &hps);
+
+            output (frame) = hps;
+        }
 
-        return octave_value (hps);
+        return octave_value (output);
     }
 }
@@ -23,10 +23,13 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_irregularity, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_irregularity (@var{data}, @var{method})\n"
+"@deftypefnx {Function File} {} xtract_irregularity (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the irregularity of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_irregularity function.\n"
@@ -42,58 +45,41 @@ DEFUN_DLD (xtract_irregularity, args, nargout,
 "@item \"j\"\n"
 "Use the method described by Jensen (1999).\n"
 "@end table\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the irregularity of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 2)
+    if (numArgs != 2)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
-
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
-        {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
-
-        double argumentArray [4] = {0, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
-
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
-
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
         // get method parameter
         std::string method = args (1).string_value();
 
-        // find the irregularity
-        double irregularity = 0;
+        // pick the irregularity function to use
+        int (*irregularityFunction) (const double*, const int, const void*, double*);
 
         if (method.find ("k") != std::string::npos)
         {
-            xtract_irregularity_k (spectrum, paddedLength / 2, NULL, &irregularity);
+            irregularityFunction = xtract_irregularity_k;
         }
         else if (method.find ("j") != std::string::npos)
         {
-            xtract_irregularity_j (spectrum, paddedLength / 2, NULL, &irregularity);
+            irregularityFunction = xtract_irregularity_j;
         }
         else
         {
@@ -101,6 +87,26 @@ DEFUN_DLD (xtract_irregularity, args, nargout,
             return octave_value_list();
         }
 
-        return octave_value (irregularity);
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, 0, options);
+        int paddedLength = analyser.getPaddedLength();
+
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            // find the irregularity
+            double irregularity = 0;
+            irregularityFunction (spectrum, paddedLength / 2, NULL, &irregularity);
+
+            output (frame) = irregularity;
+        }
+
+        return octave_value (output);
     }
 }
@@ -23,68 +23,70 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/bark.h"
+#include "common/frames.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_loudness, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_loudness (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_loudness (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the loudness of the signal @var{data} with sample rate @var{fs}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_loudness function.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the loudness of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 2)
+    if (numArgs != 2)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
-
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
-        {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
         // get the sample rate
         double sampleRate = args (1).double_value();
-        double sampleRateByN = sampleRate / paddedLength;
 
-        double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, sampleRate, options);
+        int paddedLength = analyser.getPaddedLength();
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+        // get the bark band limits
+        const int* barkBandLimits = XtractOctave::getBarkBandLimits (paddedLength, sampleRate);
 
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+        OCTAVE_LOCAL_BUFFER (double, barkCoefficients, XTRACT_BARK_BANDS - 1);
 
-        // get the bark band limits
-        OCTAVE_LOCAL_BUFFER (int, barkBandLimits, 26);
-        xtract_init_bark (paddedLength, sampleRate, barkBandLimits);
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
 
-        // get the bark coefficients
-        OCTAVE_LOCAL_BUFFER (double, barkCoefficients, 25);
-        xtract_bark_coefficients (spectrum, paddedLength / 2, barkBandLimits, barkCoefficients);
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
 
-        //get the loudness
-        double loudness;
-        xtract_loudness (barkCoefficients, 25, NULL, &loudness);
+            // get the bark coefficients
+            XtractOctave::findBarkCoefficients (spectrum, barkBandLimits, barkCoefficients);
+
+            //get the loudness
+            double loudness;
+            xtract_loudness (barkCoefficients, XTRACT_BARK_BANDS - 1, NULL, &loudness);
+
+            output (frame) = loudness;
+        }
 
-        return octave_value (loudness);
+        return octave_value (output);
     }
 }
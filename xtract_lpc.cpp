@@ -23,45 +23,86 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/autocorrelation.h"
+#include "common/frames.h"
 
 DEFUN_DLD (xtract_lpc, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_lpc (@var{data})\n"
+"@deftypefnx {Function File} {} xtract_lpc (@var{data}, @var{order})\n"
+"@deftypefnx {Function File} {} xtract_lpc (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the linear predictive coding coefficients of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_lpc function.\n"
+"\n"
+"@var{order} is the order of the linear predictor. The first @var{order} values returned are the reflection coefficients and the next @var{order} the predictor coefficients. If no value is given it will be set to N - 1, where N is the length of the input signal. Only the first @var{order} + 1 lags of the autocorrelation are found, through an fft when that is quicker, so small orders are cheap even for long frames.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a matrix is returned with the coefficients of each frame in the corresponding column.\n"
+"\n"
+"The \"framesize\" and \"hopsize\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 1)
+    if (! ((numArgs > 0) && (numArgs < 3)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-        const double* inputData = input.data();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
 
-        // autocorrelate the input
-        OCTAVE_LOCAL_BUFFER (double, autocorrelation, inputLength);
-        xtract_autocorrelation (inputData, inputLength, NULL, autocorrelation);
+        if (frames.isSpectrum())
+        {
+            error ("xtract_lpc: DATA must be a signal rather than a spectrum");
+            return octave_value_list();
+        }
 
-        // find lpc
-        int outputLength = 2 * (inputLength - 1);
-        OCTAVE_LOCAL_BUFFER (double, lpc, outputLength);
-        xtract_lpc (autocorrelation, inputLength, NULL, lpc);
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
 
-        // put into an output vector
-        RowVector output (outputLength);
-        int n = outputLength;
-        while (n--)
+        // get order
+        int order = inputLength - 1;
+        if (numArgs == 2)
         {
-            output (n) = lpc [n];
+            order = args (1).int_value();
+
+            // make sure order is within the correct range
+            if (! ((order > 0) && (order < inputLength)))
+            {
+                octave_stdout << "ORDER must be at least 1 and less than the length of DATA.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
+
+        // only the lags the predictor needs are found
+        XtractOctave::Autocorrelator autocorrelator (inputLength, order + 1);
+
+        // assign memory for the autocorrelation
+        OCTAVE_LOCAL_BUFFER (double, autocorrelation, order + 1);
+
+        // find lpc, one column per frame
+        int outputLength = 2 * order;
+        Matrix output (outputLength, numFrames);
+        double* lpc = output.fortran_vec();
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            // autocorrelate the input
+            autocorrelator.process (frames.getFrame (frame), autocorrelation);
+
+            // find lpc
+            xtract_lpc (autocorrelation, order + 1, NULL, lpc + frame * outputLength);
         }
 
-        return octave_value (output);
+        return XtractOctave::packResults (output);
     }
 }
@@ -23,43 +23,70 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/autocorrelation.h"
+#include "common/frames.h"
 
 DEFUN_DLD (xtract_lpcc, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_lpcc (@var{data})\n"
 "@deftypefnx {Function File} {} xtract_lpcc (@var{data}, @var{order})\n"
+"@deftypefnx {Function File} {} xtract_lpcc (@var{data}, @var{order}, @var{lpcorder})\n"
+"@deftypefnx {Function File} {} xtract_lpcc (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the linear predictive coding cepstral coefficients of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_lpcc function.\n"
 "\n"
-"@var{order} is an optional argument to chose the length of the resultant array of coefficients. It should be approximatly equal to (1.5 * (N - 1)), where N in the length of the input signal. If no value is given it will be set as close to this value as possible.\n"
+"@var{order} is an optional argument to chose the length of the resultant array of coefficients. It should be approximatly equal to (1.5 * P), where P is the order of the linear predictor. If no value is given (or it is empty) it will be set as close to this value as possible.\n"
+"\n"
+"@var{lpcorder} is the order P of the linear predictor the cepstral coefficients are found from. If no value is given it will be set to N - 1, where N is the length of the input signal. Only the first P + 1 lags of the autocorrelation are found, through an fft when that is quicker, so small orders are cheap even for long frames.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a matrix is returned with the coefficients of each frame in the corresponding column.\n"
+"\n"
+"The \"framesize\" and \"hopsize\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (! ((args.length() > 0) && (args.length() < 3)))
+    if (! ((numArgs > 0) && (numArgs < 4)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-        const double* inputData = input.data();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+
+        if (frames.isSpectrum())
+        {
+            error ("xtract_lpcc: DATA must be a signal rather than a spectrum");
+            return octave_value_list();
+        }
 
-        // autocorrelate the input
-        OCTAVE_LOCAL_BUFFER (double, autocorrelation, inputLength);
-        xtract_autocorrelation (inputData, inputLength, NULL, autocorrelation);
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
 
-        // find lpc
+        // get the order of the predictor
         int numCoefficients = inputLength - 1;
-        OCTAVE_LOCAL_BUFFER (double, lpc, 2 * numCoefficients);
-        xtract_lpc (autocorrelation, inputLength, NULL, lpc);
+        if (numArgs == 3)
+        {
+            numCoefficients = args (2).int_value();
+
+            // make sure the order is within the correct range
+            if (! ((numCoefficients > 0) && (numCoefficients < inputLength)))
+            {
+                octave_stdout << "LPCORDER must be at least 1 and less than the length of DATA.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
 
         // get order
         double order = 0;
-        if (args.length() == 2)
+        if (numArgs > 1 && ! args (1).isempty())
         {
             order = round (args (1).double_value());
         }
@@ -67,19 +94,33 @@ DEFUN_DLD (xtract_lpcc, args, nargout,
         {
             order = round (1.5 * numCoefficients);
         }
-        
-        // find lpcc
-        OCTAVE_LOCAL_BUFFER (double, lpcc, order);
-        xtract_lpcc (lpc + numCoefficients, numCoefficients, &order, lpcc);
-
-        // put into an output vector
-        RowVector output (order);
-        int n = order;
-        while (n--)
+
+        // only the lags the predictor needs are found
+        XtractOctave::Autocorrelator autocorrelator (inputLength, numCoefficients + 1);
+
+        // assign memory for the autocorrelation and lpc
+        OCTAVE_LOCAL_BUFFER (double, autocorrelation, numCoefficients + 1);
+        OCTAVE_LOCAL_BUFFER (double, lpc, 2 * numCoefficients);
+
+        // find lpcc, one column per frame
+        int outputLength = order;
+        Matrix output (outputLength, numFrames);
+        double* lpcc = output.fortran_vec();
+
+        for (int frame = 0; frame < numFrames; ++frame)
         {
-            output (n) = lpcc [n];
+            OCTAVE_QUIT;
+
+            // autocorrelate the input
+            autocorrelator.process (frames.getFrame (frame), autocorrelation);
+
+            // find lpc
+            xtract_lpc (autocorrelation, numCoefficients + 1, NULL, lpc);
+
+            // find lpcc
+            xtract_lpcc (lpc + numCoefficients, numCoefficients, &order, lpcc + frame * outputLength);
         }
 
-        return octave_value (output);
+        return XtractOctave::packResults (output);
     }
 }
@@ -23,85 +23,126 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/spectrum.h"
+#include "common/mel_filters.h"
 
 DEFUN_DLD (xtract_mfcc, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_mfcc (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_mfcc (@var{data}, @var{fs}, @var{numfilters})\n"
+"@deftypefnx {Function File} {} xtract_mfcc (@var{data}, @var{fs}, @var{numfilters}, @var{fmin}, @var{fmax})\n"
+"@deftypefnx {Function File} {} xtract_mfcc (@var{data}, @var{fs}, @var{numfilters}, @var{fmin}, @var{fmax}, @var{style})\n"
+"@deftypefnx {Function File} {} xtract_mfcc (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the mfccs of the signal @var{data}, with sample rate @var{fs}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_mfcc function.\n"
+"\n"
+"@var{numfilters} is the number of mel filters to use, and so the number of coefficients returned. If no value is given this will be set to 13.\n"
+"\n"
+"@var{fmin} and @var{fmax} are the frequencies, in Hz, covered by the filter bank. If no values are given these will be set to 20 and 20000.\n"
+"\n"
+"@var{style} is either \"equal_gain\" or \"equal_area\" and sets the style of the mel filters. If no value is given \"equal_gain\" is used.\n"
+"\n"
+"The filter bank is only built the first time a particular combination of frame length, sample rate and filter settings is used. After that it is kept until xtract_clear_cache is called.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a matrix is returned with the mfccs of each frame in the corresponding column.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 2)
+    if (! ((numArgs > 1) && (numArgs < 7) && (numArgs != 4)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
+        // get sample rate
+        double fs = args (1).double_value();
 
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
+        // get the number of filters
+        int numFilters = 13;
+        if (numArgs > 2)
         {
-            if (i < inputLength)
+            numFilters = args (2).int_value();
+
+            if (numFilters < 1)
             {
-                paddedInput [i] = input (i);
+                octave_stdout << "NUMFILTERS must be at least 1.\n\n";
+                print_usage();
+                return octave_value_list();
             }
-            else
+        }
+
+        // get the frequency range
+        double minFrequency = 20;
+        double maxFrequency = 20000;
+        if (numArgs > 4)
+        {
+            minFrequency = args (3).double_value();
+            maxFrequency = args (4).double_value();
+
+            if (! ((minFrequency >= 0) && (minFrequency < maxFrequency)))
             {
-                paddedInput [i] = 0;
+                octave_stdout << "FMIN must be positive and less than FMAX.\n\n";
+                print_usage();
+                return octave_value_list();
             }
         }
 
-        // get sample rate
-        double fs = args (1).double_value();
-        double sampleRateByN = fs / paddedLength;
+        // get the filter style
+        int style = XTRACT_EQUAL_GAIN;
+        if (numArgs == 6)
+        {
+            std::string styleName = args (5).string_value();
+
+            if (styleName == "equal_gain")
+            {
+                style = XTRACT_EQUAL_GAIN;
+            }
+            else if (styleName == "equal_area")
+            {
+                style = XTRACT_EQUAL_AREA;
+            }
+            else
+            {
+                octave_stdout << "STYLE must be either \"equal_gain\" or \"equal_area\".\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
 
-        double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, fs, options);
+        int paddedLength = analyser.getPaddedLength();
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+        // get the mel filters, these are only built the first time they are used
+        xtract_mel_filter* melFilters = XtractOctave::getMelFilters (paddedLength, fs, numFilters, minFrequency, maxFrequency, style);
 
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+        // find mfccs, one column per frame
+        Matrix output (numFilters, numFrames);
+        double* mfccs = output.fortran_vec();
 
-        // set up mfcc stuff
-        xtract_mel_filter melFilters;
-        melFilters.n_filters = 13;
-        OCTAVE_LOCAL_BUFFER (double*, filterArrays, 13);
-        melFilters.filters = filterArrays;
-        for(int n = 0; n < 13; ++n)
-        {
-            melFilters.filters [n] = new double [paddedLength];
-        }
-        
-        // find mfccs
-        OCTAVE_LOCAL_BUFFER (double, mfccs, 13);
-        xtract_init_mfcc(paddedLength / 2, fs / 2, XTRACT_EQUAL_GAIN, 20, 20000, melFilters.n_filters, melFilters.filters);
-        xtract_mfcc(spectrum, paddedLength / 2, &melFilters, mfccs);
-
-        // free memory
-        for(int n = 0; n < 13; ++n)
+        for (int frame = 0; frame < numFrames; ++frame)
         {
-            delete[] melFilters.filters [n];
-        }
+            OCTAVE_QUIT;
 
-        // put into an output vector
-        RowVector output (13);
-        int n = 13;
-        while (n--)
-        {
-            output (n) = mfccs [n];
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            xtract_mfcc(spectrum, paddedLength / 2, melFilters, mfccs + frame * numFilters);
         }
 
-        return octave_value (output);
+        return XtractOctave::packResults (output);
     }
 }
@@ -23,72 +23,59 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/peaks.h"
+#include "common/scratch.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_noisiness, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_noisiness (@var{data}, @var{fs}, @var{f0})\n"
 "@deftypefnx {Function File} {} xtract_noisiness (@var{data}, @var{fs}, @var{f0}, @var{threshold})\n"
+"@deftypefnx {Function File} {} xtract_noisiness (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the noisiness of the signal @var{data} with sample rate @var{fs} and fundamental frequency @var{f0}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_noisiness function.\n"
 "\n"
 "@var{threshold} is the threshold used when finding the harmonic partials. It takes a value between 0 and 1 inclusive. If no value is given this will be set to 0.2.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the noisiness of each frame is returned. In this case @var{f0} can either be a scalar, or a vector giving the fundamental frequency of each frame.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\", \"precision\", \"peakthreshold\" and \"maxpeaks\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (! ((args.length() > 2) && (args.length() < 5)))
+    if (! ((numArgs > 2) && (numArgs < 5)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
-
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
-        {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
         // get the sample rate
         double sampleRate = args (1).double_value();
-        double sampleRateByN = sampleRate / paddedLength;
-
-        double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
-
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
-
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
-
-        // assign memory for the peak finding algorithms
-        OCTAVE_LOCAL_BUFFER (double, peaks, paddedLength);
 
-        // find spectral peaks
-        argumentArray [1] = 10;
-        xtract_peak_spectrum (spectrum, paddedLength / 2, argumentArray, peaks);
-        
         // get f0
-        double f0 = args (2).double_value();
+        XtractOctave::FrameParameter f0 (args (2), numFrames);
+
+        if (! f0.isValid())
+        {
+            octave_stdout << "F0 must be a scalar or have one element per frame.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
 
         // get threshold
         double threshold = 0;
-        if (args.length() == 4)
+        if (numArgs == 4)
         {
             threshold = args (3).double_value();
 
@@ -105,35 +92,61 @@ DEFUN_DLD (xtract_noisiness, args, nargout,
             threshold = 0.2;
         }
 
-        // find harmonics
-        OCTAVE_LOCAL_BUFFER (double, harmonics, paddedLength);
-        argumentArray [0] = f0;
-        argumentArray [1] = threshold;
-        xtract_harmonic_spectrum (peaks, paddedLength, argumentArray, harmonics);
-
-        // find number of partials and harmonics
-        int numPartials = 0;
-        int numHarmonics = 0;
-        int n = paddedLength / 2;
-        while (n--)
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, sampleRate, options);
+        int paddedLength = analyser.getPaddedLength();
+
+        // set up the peak picking, with "maxpeaks" only the largest peaks
+        // are kept so the harmonics only have that many to look through
+        XtractOctave::PeakPicker peakPicker (paddedLength, analyser.getSampleRateByN(), options.peakThreshold, options.maxPeaks);
+        int peakSpectrumLength = peakPicker.getPeakSpectrumLength();
+
+        // get scratch memory for the peak finding algorithms
+        double* peaks = XtractOctave::getScratch (XtractOctave::peaksBuffer, paddedLength);
+        double* harmonics = XtractOctave::getScratch (XtractOctave::harmonicsBuffer, paddedLength);
+
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
         {
-            if (peaks [n] > 0)
-            {
-                ++numPartials;
-            }
+            OCTAVE_QUIT;
+
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            // find spectral peaks
+            peakPicker.findPeaks (spectrum, peaks);
+
+            // find harmonics
+            double argumentArray [2] = {f0 [frame], threshold};
+            xtract_harmonic_spectrum (peaks, peakSpectrumLength, argumentArray, harmonics);
 
-            if (harmonics [n] > 0)
+            // find number of partials and harmonics
+            int numPartials = 0;
+            int numHarmonics = 0;
+            int n = peakSpectrumLength / 2;
+            while (n--)
             {
-                ++numHarmonics;
+                if (peaks [n] > 0)
+                {
+                    ++numPartials;
+                }
+
+                if (harmonics [n] > 0)
+                {
+                    ++numHarmonics;
+                }
             }
-        }
 
-        // find the noisiness
-        double noisiness = 0;
-        argumentArray [0] = numHarmonics;
-        argumentArray [1] = numPartials;
-        xtract_noisiness (NULL, 0, argumentArray, &noisiness);
+            // find the noisiness
+            double noisiness = 0;
+            argumentArray [0] = numHarmonics;
+            argumentArray [1] = numPartials;
+            xtract_noisiness (NULL, 0, argumentArray, &noisiness);
+
+            output (frame) = noisiness;
+        }
 
-        return octave_value (noisiness);
+        return octave_value (output);
     }
 }
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/peaks.h"
+#include "common/scratch.h"
+#include "common/spectrum.h"
+#include <algorithm>
+
+DEFUN_DLD (xtract_peaks, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {[@var{magnitudes}, @var{frequencies}] =} xtract_peaks (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {[@var{magnitudes}, @var{frequencies}] =} xtract_peaks (@dots{}, @var{option}, @var{value}, @dots{})\n"
+"Find the spectral peaks of the signal @var{data} with sample rate @var{fs}.\n"
+"\n"
+"The peaks are found in the same way as LibXtract\'s xtract_peak_spectrum finds them, with the magnitude and frequency of each interpolated from the bins around it, but only the peaks themselves are returned. @var{magnitudes} and @var{frequencies} hold the peaks in order of frequency, padded with zeros if there are fewer peaks than the length of the result.\n"
+"\n"
+"The \"peakthreshold\" option sets the percentage of the largest magnitude in the spectrum a peak must reach, 10 by default. The \"maxpeaks\" option keeps only that many of the largest peaks, and the result is then always that long. Otherwise the result is as long as the largest number of peaks found in a frame. The same options choose the peaks used by the harmonic functions.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and the results have one column per frame.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
+"@end deftypefn\n")
+{
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
+    // make sure the correct amount of arguments have been passed
+    if (numArgs != 2)
+    {
+        print_usage();
+        return octave_value_list();
+    }
+    else
+    {
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
+
+        // get the sample rate
+        double sampleRate = args (1).double_value();
+
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, sampleRate, options);
+        int paddedLength = analyser.getPaddedLength();
+
+        // without a maximum every peak could be kept, so they are packed
+        // into as many slots as there are bins and trimmed afterwards
+        int maxPeaks = options.maxPeaks > 0 ? options.maxPeaks : paddedLength / 2;
+        XtractOctave::PeakPicker peakPicker (paddedLength, analyser.getSampleRateByN(), options.peakThreshold, maxPeaks);
+        int numSlots = peakPicker.getPeakSpectrumLength() / 2;
+
+        // get scratch memory for the peak finding algorithm
+        double* peaks = XtractOctave::getScratch (XtractOctave::peaksBuffer, paddedLength);
+
+        Matrix magnitudes (numSlots, numFrames);
+        Matrix frequencies (numSlots, numFrames);
+        int mostPeaks = 0;
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            // find the peaks
+            int numPeaks = peakPicker.findPeaks (spectrum, peaks);
+            mostPeaks = std::max (mostPeaks, numPeaks);
+
+            std::copy (peaks, peaks + numSlots, magnitudes.fortran_vec() + frame * numSlots);
+            std::copy (peaks + numSlots, peaks + 2 * numSlots, frequencies.fortran_vec() + frame * numSlots);
+        }
+
+        // drop the slots no frame needed
+        if (options.maxPeaks == 0)
+        {
+            magnitudes = magnitudes.extract_n (0, 0, mostPeaks, numFrames);
+            frequencies = frequencies.extract_n (0, 0, mostPeaks, numFrames);
+        }
+
+        octave_value_list output;
+        output (0) = XtractOctave::packResults (magnitudes);
+        output (1) = XtractOctave::packResults (frequencies);
+
+        return output;
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include "common/feature_file.h"
+#include <limits>
+#include <memory>
+#include <string>
+
+DEFUN_DLD (xtract_read_features, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {[@var{result}, @var{framerate}] =} xtract_read_features (@var{filename})\n"
+"Read the features written to the feature file @var{filename} by the \"output\" option of xtract_features or xtract_file_features.\n"
+"\n"
+"The result is a struct with a field for each feature, holding a matrix with one column per frame as xtract_features would have returned it. Files written in single precision are read as single precision. @var{framerate} is the number of frames a second, or 0 if it wasn't known when the file was written.\n"
+"\n"
+"The file is read through a memory map and each feature is copied once, straight into the matrix returned. The format is described in common/feature_file.h, so the files can just as easily be mapped by other programs.\n"
+"@end deftypefn\n")
+{
+    // make sure the correct amount of arguments have been passed
+    if (args.length() != 1 || ! args (0).is_string())
+    {
+        print_usage();
+        return octave_value_list();
+    }
+    else
+    {
+        std::string path = args (0).string_value();
+        std::string problem;
+        std::unique_ptr<XtractOctave::FeatureFile> file (XtractOctave::FeatureFile::open (path, problem));
+
+        if (! file)
+        {
+            error ("xtract_read_features: %s can't be read, %s", path.c_str(), problem.c_str());
+            return octave_value_list();
+        }
+
+        // opening the file checked each feature's values fit in it, but
+        // the frame count still has to fit in a matrix dimension
+        if (file->getNumFrames() > std::numeric_limits<int>::max())
+        {
+            error ("xtract_read_features: %s has too many frames to read", path.c_str());
+            return octave_value_list();
+        }
+
+        int numFrames = file->getNumFrames();
+
+        // put the features into a struct
+        octave_scalar_map output;
+
+        for (int i = 0; i < file->getNumFeatures(); ++i)
+        {
+            int length = file->getLength (i);
+
+            if (file->isSinglePrecision())
+            {
+                FloatMatrix values (length, numFrames);
+                file->read (i, values.fortran_vec());
+                output.assign (file->getName (i), octave_value (numFrames == 1 ? values.transpose() : values));
+            }
+            else
+            {
+                Matrix values (length, numFrames);
+                file->read (i, values.fortran_vec());
+                output.assign (file->getName (i), octave_value (numFrames == 1 ? values.transpose() : values));
+            }
+        }
+
+        octave_value_list outputs;
+        outputs (0) = octave_value (output);
+        outputs (1) = octave_value (file->getFrameRate());
+
+        return outputs;
+    }
+}
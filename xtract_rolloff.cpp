@@ -23,67 +23,68 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_rolloff, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_rolloff (@var{data}, @var{threshold})\n"
+"@deftypefnx {Function File} {} xtract_rolloff (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the spectral rolloff of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_rolloff function.\n"
 "\n"
 "The second argument @var{threshold} sets the threshold for rolloff expressed as a percentage.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the rolloff of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 2)
+    if (numArgs != 2)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
-
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
-        {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
         // get the sample rate
         double sampleRate = args (1).double_value();
-        double sampleRateByN = sampleRate / paddedLength;
 
-        double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, sampleRate, options);
+        int paddedLength = analyser.getPaddedLength();
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
-
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
-       
         // get the threshold
         double threshold = args (1).double_value();
 
-        argumentArray [1] = threshold;
+        double argumentArray [2] = {analyser.getSampleRateByN(), threshold};
+
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
 
-        // find the rolloff
-        double rolloff = 0;
-        xtract_rolloff (spectrum, paddedLength / 2, argumentArray, &rolloff);
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            // find the rolloff
+            double rolloff = 0;
+            xtract_rolloff (spectrum, paddedLength / 2, argumentArray, &rolloff);
+
+            output (frame) = rolloff;
+        }
 
-        return octave_value (rolloff);
+        return octave_value (output);
     }
 }
@@ -23,56 +23,88 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/bark.h"
+#include "common/frames.h"
+#include "common/spectral_stream.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_sharpness, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_sharpness (@var{data})\n"
-"Calculate the spectral centroid of the signal @var{data}.\n"
+"@deftypefnx {Function File} {} xtract_sharpness (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_sharpness (@dots{}, @var{option}, @var{value}, @dots{})\n"
+"Calculate the sharpness of the signal @var{data} with sample rate @var{fs}.\n"
 "\n"
-"A wrapper for LibXtract\'s xtract_sharpness function.\n"
+"A wrapper for LibXtract\'s xtract_sharpness function. The sharpness is found from the bark coefficients of the signal (as xtract_loudness is), so the sample rate is needed to find the bark bands. @var{fs} is 44100 if it isn't given, or the stream's sample rate with the \"stream\" option, but it must be given with \"input\", \"spectrum\".\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the sharpness of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 1)
+    if (! ((numArgs > 0) && (numArgs < 3)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
+        // a spectrum's bands can't be placed without its sample rate
+        if ((numArgs == 1) && (options.input == "spectrum"))
+        {
+            octave_stdout << "FS must be given when the input is a spectrum.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
 
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
+        // get the sample rate
+        double sampleRate = 44100;
+        if (numArgs == 2)
+        {
+            sampleRate = args (1).double_value();
+        }
+        else if (options.stream != 0)
         {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
+            sampleRate = XtractOctave::getSpectralStreams().get (options.stream)->getSampleRate();
         }
 
-        double argumentArray [4] = {0, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, sampleRate, options);
+        int paddedLength = analyser.getPaddedLength();
+
+        // get the bark band limits
+        const int* barkBandLimits = XtractOctave::getBarkBandLimits (paddedLength, sampleRate);
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+        OCTAVE_LOCAL_BUFFER (double, barkCoefficients, XTRACT_BARK_BANDS - 1);
 
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
-        
-        // find the spectral centroid
-        double sharpness = 0;
-        xtract_sharpness (spectrum, paddedLength / 2, NULL, &sharpness);
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            // get the bark coefficients
+            XtractOctave::findBarkCoefficients (spectrum, barkBandLimits, barkCoefficients);
+
+            // find the sharpness
+            double sharpness = 0;
+            xtract_sharpness (barkCoefficients, XTRACT_BARK_BANDS - 1, NULL, &sharpness);
+
+            output (frame) = sharpness;
+        }
 
-        return octave_value (sharpness);
+        return octave_value (output);
     }
 }
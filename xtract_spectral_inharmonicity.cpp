@@ -23,70 +23,85 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/peaks.h"
+#include "common/scratch.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_spectral_inharmonicity, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_spectral_inharmonicity (@var{data}, @var{fs}, @var{f0})\n"
+"@deftypefnx {Function File} {} xtract_spectral_inharmonicity (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the spectral inharmonicity of the signal @var{data} with sample rate @var{fs} and fundamental frequency @var{f0}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_spectral_inharmonicity function.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the inharmonicity of each frame is returned. In this case @var{f0} can either be a scalar, or a vector giving the fundamental frequency of each frame.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\", \"precision\", \"peakthreshold\" and \"maxpeaks\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 3)
+    if (numArgs != 3)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
+        // get the sample rate
+        double sampleRate = args (1).double_value();
+
+        // get f0
+        XtractOctave::FrameParameter f0 (args (2), numFrames);
 
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
+        if (! f0.isValid())
         {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
+            octave_stdout << "F0 must be a scalar or have one element per frame.\n\n";
+            print_usage();
+            return octave_value_list();
         }
 
-        // get the sample rate
-        double sampleRate = args (1).double_value();
-        double sampleRateByN = sampleRate / paddedLength;
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, sampleRate, options);
+        int paddedLength = analyser.getPaddedLength();
 
-        double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        // set up the peak picking, with "maxpeaks" only the largest peaks
+        // are kept so the harmonics only have that many to look through
+        XtractOctave::PeakPicker peakPicker (paddedLength, analyser.getSampleRateByN(), options.peakThreshold, options.maxPeaks);
+        int peakSpectrumLength = peakPicker.getPeakSpectrumLength();
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+        // get scratch memory for the peak finding algorithms
+        double* peaks = XtractOctave::getScratch (XtractOctave::peaksBuffer, paddedLength);
 
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+        RowVector output (numFrames);
 
-        // assign memory for the peak finding algorithms
-        OCTAVE_LOCAL_BUFFER (double, peaks, paddedLength);
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
 
-        // find spectral peaks
-        argumentArray [1] = 10;
-        xtract_peak_spectrum (spectrum, paddedLength / 2, argumentArray, peaks);
-        
-        // get f0
-        double f0 = args (2).double_value();
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
 
-        // find the spectral inharmonicity
-        double spectralInharmonicity = 0;
-        xtract_spectral_inharmonicity (peaks, paddedLength, &f0, &spectralInharmonicity);
+            // find spectral peaks
+            peakPicker.findPeaks (spectrum, peaks);
+
+            // find the spectral inharmonicity
+            double frameF0 = f0 [frame];
+            double spectralInharmonicity = 0;
+            xtract_spectral_inharmonicity (peaks, peakSpectrumLength, &frameF0, &spectralInharmonicity);
+
+            output (frame) = spectralInharmonicity;
+        }
 
-        return octave_value (spectralInharmonicity);
+        return octave_value (output);
     }
 }
@@ -23,72 +23,73 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_spectral_skewness, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_spectral_skewness (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_spectral_skewness (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the spectral skewness of the signal @var{data} with sample rate @var{fs}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_spectral_skewness function.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the spectral skewness of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 2)
+    if (numArgs != 2)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
-
-        // zero pad the input so it is a power of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
-        {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
         // get the sample rate
         double sampleRate = args (1).double_value();
-        double sampleRateByN = sampleRate / paddedLength;
 
-        double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, sampleRate, options);
+        int paddedLength = analyser.getPaddedLength();
+
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+            // find the spectral mean
+            double spectralMean = 0;
+            xtract_spectral_mean (spectrum, paddedLength, NULL, &spectralMean);
 
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
-        
-        // find the spectral mean
-        double spectralMean = 0;
-        xtract_spectral_mean (spectrum, paddedLength, NULL, &spectralMean);
+            // find the spectral variance
+            double spectralVariance = 0;
+            xtract_spectral_variance (spectrum, paddedLength, &spectralMean, &spectralVariance);
 
-        // find the spectral variance
-        double spectralVariance = 0;
-        xtract_spectral_variance (spectrum, paddedLength, &spectralMean, &spectralVariance);
+            // find the spectral standard deviation
+            double spectralStandardDeviation = sqrt (spectralVariance);
 
-        // find the spectral standard deviation
-        double spectralStandardDeviation = sqrt (spectralVariance);
+            // find the spectral skewness
+            double spectralMeanAndDeviation [2] = {spectralMean, spectralStandardDeviation};
+            double spectralSkewness = 0;
+            xtract_spectral_skewness (spectrum, paddedLength, spectralMeanAndDeviation, &spectralSkewness);
 
-        // find the spectral skewness
-        double spectralMeanAndDeviation [2] = {spectralMean, spectralStandardDeviation};
-        double spectralSkewness = 0;
-        xtract_spectral_skewness (spectrum, paddedLength, spectralMeanAndDeviation, &spectralSkewness);
+            output (frame) = spectralSkewness;
+        }
 
-        return octave_value (spectralSkewness);
+        return octave_value (output);
     }
 }
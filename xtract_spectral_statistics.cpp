@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include "common/frames.h"
+#include "common/spectral_statistics.h"
+#include <string>
+#include <vector>
+
+DEFUN_DLD (xtract_spectral_statistics, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {@var{handle} =} xtract_spectral_statistics (\"create\", @var{fs})\n"
+"@deftypefnx {Function File} {@var{handle} =} xtract_spectral_statistics (\"create\", @var{fs}, @var{features})\n"
+"@deftypefnx {Function File} {} xtract_spectral_statistics (\"add\", @var{handle}, @var{data})\n"
+"@deftypefnx {Function File} {} xtract_spectral_statistics (\"add\", @var{handle}, @var{data}, @var{option}, @var{value}, @dots{})\n"
+"@deftypefnx {Function File} {} xtract_spectral_statistics (\"merge\", @var{handle}, @var{other})\n"
+"@deftypefnx {Function File} {@var{summary} =} xtract_spectral_statistics (\"summary\", @var{handle})\n"
+"@deftypefnx {Function File} {} xtract_spectral_statistics (\"reset\", @var{handle})\n"
+"@deftypefnx {Function File} {} xtract_spectral_statistics (\"destroy\", @var{handle})\n"
+"Keep running summary statistics of spectral features over any number of frames.\n"
+"\n"
+"\"create\" returns the handle of a new accumulator for signals with sample rate @var{fs}. @var{features} is a cell array of the features to summarise, which can be any of the single valued features xtract_features recognises which don\'t need an f0. If it isn\'t given spectral_centroid, spectral_variance, spectral_skewness and spectral_kurtosis are summarised.\n"
+"\n"
+"\"add\" analyses the frames in @var{data} (treated as xtract_features treats them, including any options) and adds each feature\'s value for each frame to the statistics. Only the running moments of each feature are kept, so the memory used doesn\'t depend on the number of frames.\n"
+"\n"
+"\"merge\" adds everything accumulated by @var{other} (which must summarise the same features) to @var{handle}, so long signals can be split up and summarised separately.\n"
+"\n"
+"\"summary\" returns a struct with a field for each feature, holding a struct with the count, mean, variance, skewness, kurtosis, min and max of its values. These match Octave\'s var, skewness and kurtosis.\n"
+"\n"
+"\"reset\" clears the statistics and \"destroy\" frees the accumulator, its handle can\'t be used again.\n"
+"@end deftypefn\n")
+{
+    int numArgs = args.length();
+
+    // make sure the correct amount of arguments have been passed
+    if (numArgs < 2 || ! args (0).is_string())
+    {
+        print_usage();
+        return octave_value_list();
+    }
+
+    std::string action = args (0).string_value();
+    XtractOctave::HandleRegistry<XtractOctave::SpectralStatistics>& accumulators = XtractOctave::getSpectralStatistics();
+
+    if (action == "create")
+    {
+        if (! ((numArgs > 1) && (numArgs < 4)))
+        {
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get the sample rate
+        double sampleRate = args (1).double_value();
+
+        // get the features to summarise
+        std::vector<std::string> names;
+
+        if (numArgs == 3)
+        {
+            if (! (args (2).is_string() || args (2).iscellstr()))
+            {
+                octave_stdout << "FEATURES must be a string or a cell array of strings.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+
+            string_vector givenNames = args (2).string_vector_value();
+
+            for (int i = 0; i < givenNames.numel(); ++i)
+            {
+                names.push_back (givenNames [i]);
+            }
+        }
+        else
+        {
+            names.push_back ("spectral_centroid");
+            names.push_back ("spectral_variance");
+            names.push_back ("spectral_skewness");
+            names.push_back ("spectral_kurtosis");
+        }
+
+        std::vector<const XtractOctave::Feature*> features;
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            const XtractOctave::Feature* feature = XtractOctave::findFeature (names [i]);
+
+            if (feature == NULL)
+            {
+                error ("xtract_spectral_statistics: unknown feature \"%s\"", names [i].c_str());
+                return octave_value_list();
+            }
+
+            if (feature->length != 1 || feature->needsF0)
+            {
+                error ("xtract_spectral_statistics: %s can't be summarised", names [i].c_str());
+                return octave_value_list();
+            }
+
+            features.push_back (feature);
+        }
+
+        int handle = accumulators.add (new XtractOctave::SpectralStatistics (sampleRate, features));
+
+        return octave_value (handle);
+    }
+
+    // all the other actions need an accumulator
+    int handle = args (1).int_value();
+    XtractOctave::SpectralStatistics* statistics = accumulators.get (handle);
+
+    if (statistics == NULL)
+    {
+        error ("xtract_spectral_statistics: there is no accumulator with handle %d", handle);
+        return octave_value_list();
+    }
+
+    if (action == "add")
+    {
+        // split any options off the end of the arguments
+        XtractOctave::Options options;
+        int numPositionalArgs = XtractOctave::parseOptions (args, options);
+
+        if (numPositionalArgs != 3)
+        {
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get the input frames
+        XtractOctave::Frames frames (args (2), options);
+
+        const std::vector<const XtractOctave::Feature*>& features = statistics->getFeatures();
+
+        for (size_t i = 0; i < features.size(); ++i)
+        {
+            if (features [i]->needsSignal && frames.isSpectrum())
+            {
+                error ("xtract_spectral_statistics: %s can't be found from a spectrum", features [i]->name);
+                return octave_value_list();
+            }
+        }
+
+        statistics->addFrames (frames, options);
+
+        return octave_value_list();
+    }
+    else if (action == "merge" && numArgs == 3)
+    {
+        int otherHandle = args (2).int_value();
+        XtractOctave::SpectralStatistics* other = accumulators.get (otherHandle);
+
+        if (other == NULL)
+        {
+            error ("xtract_spectral_statistics: there is no accumulator with handle %d", otherHandle);
+            return octave_value_list();
+        }
+
+        if (other->getFeatures() != statistics->getFeatures())
+        {
+            error ("xtract_spectral_statistics: accumulators must summarise the same features to be merged");
+            return octave_value_list();
+        }
+
+        if (other != statistics)
+        {
+            statistics->merge (*other);
+        }
+
+        return octave_value_list();
+    }
+    else if (action == "summary" && numArgs == 2)
+    {
+        octave_scalar_map output;
+        const std::vector<const XtractOctave::Feature*>& features = statistics->getFeatures();
+
+        for (size_t i = 0; i < features.size(); ++i)
+        {
+            const XtractOctave::RunningMoments& moments = statistics->getMoments (i);
+
+            octave_scalar_map summary;
+            summary.assign ("count", moments.getCount());
+            summary.assign ("mean", moments.getMean());
+            summary.assign ("variance", moments.getVariance());
+            summary.assign ("skewness", moments.getSkewness());
+            summary.assign ("kurtosis", moments.getKurtosis());
+            summary.assign ("min", moments.getMinimum());
+            summary.assign ("max", moments.getMaximum());
+
+            output.assign (features [i]->name, summary);
+        }
+
+        return octave_value (output);
+    }
+    else if (action == "reset" && numArgs == 2)
+    {
+        statistics->reset();
+        return octave_value_list();
+    }
+    else if (action == "destroy" && numArgs == 2)
+    {
+        accumulators.remove (handle);
+        return octave_value_list();
+    }
+    else
+    {
+        print_usage();
+        return octave_value_list();
+    }
+}
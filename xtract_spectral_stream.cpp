@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2014 Sean Enderby
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#include <octave/oct.h>
+#include "common/spectral_stream.h"
+#include "common/options.h"
+#include <string>
+
+DEFUN_DLD (xtract_spectral_stream, args, nargout,
+"-*- texinfo -*-\n"
+"@deftypefn {Function File} {@var{handle} =} xtract_spectral_stream (\"create\", @var{fs}, @var{framesize})\n"
+"@deftypefnx {Function File} {@var{handle} =} xtract_spectral_stream (\"create\", @var{fs}, @var{framesize}, @var{hopsize})\n"
+"@deftypefnx {Function File} {@var{handle} =} xtract_spectral_stream (\"create\", @var{fs}, @var{framesize}, @var{hopsize}, @var{method})\n"
+"@deftypefnx {Function File} {@var{handle} =} xtract_spectral_stream (\"create\", @var{fs}, @var{framesize}, @var{hopsize}, \"sliding\", @var{resync})\n"
+"@deftypefnx {Function File} {@var{handle} =} xtract_spectral_stream (\"create\", @dots{}, @var{option}, @var{value}, @dots{})\n"
+"@deftypefnx {Function File} {@var{n} =} xtract_spectral_stream (\"process\", @var{handle}, @var{data})\n"
+"@deftypefnx {Function File} {@var{spectra} =} xtract_spectral_stream (\"spectra\", @var{handle})\n"
+"@deftypefnx {Function File} {} xtract_spectral_stream (\"reset\", @var{handle})\n"
+"@deftypefnx {Function File} {} xtract_spectral_stream (\"destroy\", @var{handle})\n"
+"Find the spectra of a signal which is passed in as a series of blocks, for use by any of the spectral functions.\n"
+"\n"
+"\"create\" returns the handle of a new stream for a signal with sample rate @var{fs}, which is split into frames @var{framesize} samples long starting @var{hopsize} samples apart. If no @var{hopsize} is given the frames don't overlap. The \"window\", \"fftsize\" and \"precision\" options can be given after the other arguments and are used for every frame.\n"
+"\n"
+"@var{method} is either \"fft\" (the default), which finds the spectrum of each frame with a full fft, or \"sliding\", which updates the spectrum with a sliding dft as each sample arrives. The sliding dft costs a multiply and add per bin for every sample rather than an fft per frame, so it is quicker when the hop is only a few samples. To stop rounding errors building up the bins are found again with a full fft every @var{resync} frames, by default about once every @var{framesize} samples. The sliding method can only use a rectangular window and always works in double precision.\n"
+"\n"
+"\"process\" passes the next @var{data} samples of the signal (a vector of any length, usually a hop) to a stream and returns the number of frames they complete. The current frame is kept in a ring buffer, so each sample is only copied in once however much the frames overlap and each completed frame costs a single fft.\n"
+"\n"
+"The spectra of the frames completed by the last block can be used by any function which takes the \"input\", \"spectrum\" option by passing it an empty @var{data} and the \"stream\", @var{handle} option, with the same sample rate as the stream, for example:\n"
+"\n"
+"@example\n"
+"xtract_spectral_stream (\"process\", h, block);\n"
+"centroid = xtract_spectral_centroid ([], fs, \"stream\", h);\n"
+"@end example\n"
+"\n"
+"\"spectra\" returns them as a matrix with one spectrum per column, laid out as xtract_spectrum lays them out.\n"
+"\n"
+"\"reset\" forgets the samples and spectra kept by a stream, ready for a new signal. \"destroy\" frees a stream, its handle can't be used again.\n"
+"@end deftypefn\n")
+{
+    int numArgs = args.length();
+
+    // make sure the correct amount of arguments have been passed
+    if (numArgs < 2 || ! args (0).is_string())
+    {
+        print_usage();
+        return octave_value_list();
+    }
+
+    std::string action = args (0).string_value();
+    XtractOctave::HandleRegistry<XtractOctave::SpectralStream>& streams = XtractOctave::getSpectralStreams();
+
+    if (action == "create")
+    {
+        // split any options off the end of the arguments
+        XtractOctave::Options options;
+        numArgs = XtractOctave::parseOptions (args, options);
+
+        if (! ((numArgs > 2) && (numArgs < 7)))
+        {
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get the sample rate
+        double sampleRate = args (1).double_value();
+
+        // get the frame and hop sizes
+        int frameSize = args (2).int_value();
+        int hopSize = frameSize;
+
+        if (numArgs > 3)
+        {
+            hopSize = args (3).int_value();
+        }
+
+        if (frameSize < 1 || hopSize < 1)
+        {
+            octave_stdout << "FRAMESIZE and HOPSIZE must be at least 1.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        // get the method
+        XtractOctave::SpectralStream::Method method = XtractOctave::SpectralStream::fftMethod;
+        int resyncInterval = 0;
+
+        if (numArgs > 4)
+        {
+            std::string methodName = args (4).string_value();
+
+            if (methodName == "fft" && numArgs == 5)
+            {
+                method = XtractOctave::SpectralStream::fftMethod;
+            }
+            else if (methodName == "sliding")
+            {
+                method = XtractOctave::SpectralStream::slidingMethod;
+            }
+            else
+            {
+                octave_stdout << "METHOD must be either \"fft\" or \"sliding\".\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
+
+        if (numArgs == 6)
+        {
+            resyncInterval = args (5).int_value();
+
+            if (resyncInterval < 1)
+            {
+                octave_stdout << "RESYNC must be at least 1.\n\n";
+                print_usage();
+                return octave_value_list();
+            }
+        }
+
+        int handle = streams.add (new XtractOctave::SpectralStream (sampleRate, frameSize, hopSize, options,
+                                                                    method, resyncInterval));
+
+        return octave_value (handle);
+    }
+
+    // all the other actions need a stream
+    int handle = args (1).int_value();
+    XtractOctave::SpectralStream* stream = streams.get (handle);
+
+    if (stream == NULL)
+    {
+        error ("xtract_spectral_stream: there is no stream with handle %d", handle);
+        return octave_value_list();
+    }
+
+    if (action == "process")
+    {
+        if (numArgs != 3)
+        {
+            print_usage();
+            return octave_value_list();
+        }
+
+        // the samples are read straight from the argument
+        NDArray data = args (2).array_value();
+
+        if (! (data.isempty() || data.rows() == 1 || data.columns() == 1))
+        {
+            octave_stdout << "DATA must be a vector.\n\n";
+            print_usage();
+            return octave_value_list();
+        }
+
+        return octave_value (stream->process (data.data(), data.numel()));
+    }
+    else if (action == "spectra" && numArgs == 2)
+    {
+        return octave_value (stream->getSpectra());
+    }
+    else if (action == "reset" && numArgs == 2)
+    {
+        stream->reset();
+        return octave_value_list();
+    }
+    else if (action == "destroy" && numArgs == 2)
+    {
+        streams.remove (handle);
+        return octave_value_list();
+    }
+    else
+    {
+        print_usage();
+        return octave_value_list();
+    }
+}
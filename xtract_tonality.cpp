@@ -23,27 +23,39 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_tonality, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_tonality (@var{data})\n"
+"@deftypefnx {Function File} {} xtract_tonality (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the tonality of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_tonality function.\n"
 "For now only short lengths of input data (<= 128) should be used. I will endeavour to fix this at some point.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the tonality of each frame is returned.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\" and \"precision\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 1)
+    if (numArgs != 1)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
 
         // warn about too long an input vector
         if (inputLength > 128)
@@ -51,43 +63,34 @@ DEFUN_DLD (xtract_tonality, args, nargout,
             warning ("This function has serious issue with long input vectors. Try to keep your input vector length at or below 128. If not you are likely to get exceedingly inaccurate values.");
         }
 
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, 0, options);
+        int paddedLength = analyser.getPaddedLength();
 
-        // zero pad the input so it is a tonality of 2 in length
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
-        {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
-            {
-                paddedInput [i] = 0;
-            }
-        }
+        RowVector output (numFrames);
 
-        double argumentArray [4] = {0, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
 
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+            // find the spectral flatness
+            double spectralFlatness = 0;
+            xtract_flatness (spectrum, paddedLength / 2, NULL, &spectralFlatness);
 
-        // find the spectral flatness
-        double spectralFlatness = 0;
-        xtract_flatness (spectrum, paddedLength / 2, NULL, &spectralFlatness);
+            // find the dB spectral flatness
+            double spectralFlatnessDB = 0;
+            xtract_flatness_db (NULL, 0, &spectralFlatness, &spectralFlatnessDB);
 
-        // find the dB spectral flatness
-        double spectralFlatnessDB = 0;
-        xtract_flatness_db (NULL, 0, &spectralFlatness, &spectralFlatnessDB);
+            // find the tonality
+            double tonality = 0;
+            xtract_tonality (NULL, 0, &spectralFlatnessDB, &tonality);
 
-        // find the tonality
-        double tonality = 0;
-        xtract_tonality (NULL, 0, &spectralFlatnessDB, &tonality);
+            output (frame) = tonality;
+        }
 
-        return octave_value (tonality);
+        return octave_value (output);
     }
 }
@@ -23,77 +23,87 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
+#include "common/peaks.h"
+#include "common/scratch.h"
+#include "common/spectrum.h"
 
 DEFUN_DLD (xtract_tristimulus, args, nargout,
 "-*- texinfo -*-\n"
-"@deftypefn {Function File} {} xtract_tristimulus (@var{data}, @var{fs}, @var{order})\n"
+"@deftypefn {Function File} {} xtract_tristimulus (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_tristimulus (@var{data}, @var{fs}, @var{order})\n"
 "@deftypefnx {Function File} {} xtract_tristimulus (@var{data}, @var{fs}, @var{order}, @var{f0})\n"
 "@deftypefnx {Function File} {} xtract_tristimulus (@var{data}, @var{fs}, @var{order}, @var{f0}, @var{threshold})\n"
+"@deftypefnx {Function File} {} xtract_tristimulus (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the tristimulus of order @var{order} of the signal @var{data} with sample rate @var{fs}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_tristimulus functions.\n"
 "\n"
-"The third argument @var{order} is the order to the tristimulus to calculate. It can be either 1, 2 or 3.\n"
+"The third argument @var{order} is the order to the tristimulus to calculate. It can be either 1, 2 or 3. If it is not given, or is empty, all three orders are found together from the same spectrum and returned as a vector, which is no slower than finding one of them.\n"
 "\n"
-"If only three input arguments are given the calculation is made using all the spectral partials of the input signal. Passing more input arguments will cause only the harmonics to be taken into account.\n"
+"If no more than three input arguments are given the calculation is made using all the spectral partials of the input signal. Passing more input arguments will cause only the harmonics to be taken into account.\n"
 "\n"
 "@var{f0} is the fundamental frequency of the input signal and is needed to find the harmonics of the input signal.\n"
 "\n"
 "@var{threshold} is the threshold used when finding the harmonic partials. It takes a value between 0 and 1 inclusive. If no value is given this will be set to 0.2.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the tristimulus of each frame is returned, or a matrix with a row for each order and a column for each frame if all three orders are found. In this case @var{f0} can either be a scalar, or a vector giving the fundamental frequency of each frame.\n"
+"\n"
+"The \"framesize\", \"hopsize\", \"window\", \"fftsize\", \"input\", \"stream\", \"precision\", \"peakthreshold\" and \"maxpeaks\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (! ((args.length() > 2) && (args.length() < 6)))
+    if (! ((numArgs > 1) && (numArgs < 6)))
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-        const double* inputData = input.data();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+        int numFrames = frames.getNumFrames();
 
         // get the sample rate
         double sampleRate = args (1).double_value();
 
-        // zero pad the input so it is a power of 2 in length
-        int paddedLength = pow (2, ceil (log2 (inputLength)));
-        OCTAVE_LOCAL_BUFFER (double, paddedInput, paddedLength);
-        for (int i = 0; i < paddedLength; ++i)
+        // get order, with no order given all three are found
+        int firstOrder = 1;
+        int lastOrder = 3;
+
+        if (numArgs > 2 && ! args (2).isempty())
         {
-            if (i < inputLength)
-            {
-                paddedInput [i] = input (i);
-            }
-            else
+            int order = args (2).int_value();
+
+            // make sure order is within the correct range
+            if (! ((order > 0) && (order < 4)))
             {
-                paddedInput [i] = 0;
+                octave_stdout << "ORDER must be between 1 and 3.\n\n";
+                print_usage();
+                return octave_value_list();
             }
-        }
-
-        double sampleRateByN = sampleRate / paddedLength;
-        double argumentArray [4] = {sampleRateByN, XTRACT_MAGNITUDE_SPECTRUM, 0, 0};
 
-        // assign memory for the output of the xtract_spectrum function
-        OCTAVE_LOCAL_BUFFER (double, spectrum, paddedLength);
-
-        // initialise and run the fft
-        xtract_init_fft (paddedLength, XTRACT_SPECTRUM);
-        xtract_spectrum (paddedInput, paddedLength, argumentArray, spectrum);
+            firstOrder = order;
+            lastOrder = order;
+        }
 
-        // assign memory for the peak finding algorithms
-        OCTAVE_LOCAL_BUFFER (double, peaks, paddedLength);
-        OCTAVE_LOCAL_BUFFER (double, harmonics, paddedLength);
+        int numOrders = lastOrder - firstOrder + 1;
 
-        // find spectral peaks
-        argumentArray [1] = 10;
-        xtract_peak_spectrum (spectrum, paddedLength / 2, argumentArray, peaks);
+        // the tristimulus functions for each order
+        int (*tristimulusFunctions [3]) (const double*, const int, const void*, double*) =
+        {
+            xtract_tristimulus_1,
+            xtract_tristimulus_2,
+            xtract_tristimulus_3
+        };
 
         // get all partials setting
         bool allPartials = 0;
-        if (args.length() > 3)
+        if (numArgs > 3)
         {
             allPartials = false;
         }
@@ -102,81 +112,90 @@ DEFUN_DLD (xtract_tristimulus, args, nargout,
             allPartials = true;
         }
 
-        // a pointer to point to the peak data which will be used
-        double* spectrumDataToUse;
+        // get f0
+        XtractOctave::FrameParameter f0 (allPartials ? octave_value (0) : args (3), numFrames);
 
-        if (allPartials)
+        if (! f0.isValid())
         {
-            spectrumDataToUse = peaks;
+            octave_stdout << "F0 must be a scalar or have one element per frame.\n\n";
+            print_usage();
+            return octave_value_list();
         }
-        else
+
+        // get threshold
+        double threshold = 0;
+        if (numArgs == 5)
         {
-            // get f0
-            double f0 = args (3).double_value();
+            threshold = args (4).double_value();
 
-            // get threshold
-            double threshold = 0;
-            if (args.length() == 5)
+            // make sure threshold is within the correct range
+            if (! ((threshold >= 0) && (threshold <=1)))
             {
-                threshold = args (4).double_value();
-
-                // make sure threshold is within the correct range
-                if (! ((threshold >= 0) && (threshold <=1)))
-                {
-                    octave_stdout << "THRESHOLD must be between 0 and 1.\n\n";
-                    print_usage();
-                    return octave_value_list();
-                }
-            }
-            else
-            {
-                threshold = 0.2;
+                octave_stdout << "THRESHOLD must be between 0 and 1.\n\n";
+                print_usage();
+                return octave_value_list();
             }
+        }
+        else
+        {
+            threshold = 0.2;
+        }
 
-            // find harmonics
-            argumentArray [0] = f0;
-            argumentArray [1] = threshold;
-            xtract_harmonic_spectrum (peaks, paddedLength, argumentArray, harmonics);
+        // set up the fft for the length of the frames
+        XtractOctave::SpectrumAnalyser analyser (frames, sampleRate, options);
+        int paddedLength = analyser.getPaddedLength();
 
-            spectrumDataToUse = harmonics;
-        }
+        // set up the peak picking, with "maxpeaks" only the largest peaks
+        // are kept so the harmonics only have that many to look through
+        XtractOctave::PeakPicker peakPicker (paddedLength, analyser.getSampleRateByN(), options.peakThreshold, options.maxPeaks);
+        int peakSpectrumLength = peakPicker.getPeakSpectrumLength();
 
-        // get order
-        int order = args (2).int_value();
-        
-        // make sure order is within the correct range
-        if (! ((order > 0) && (order < 4)))
-        {
-            octave_stdout << "ORDER must be between 1 and 3.\n\n";
-            print_usage();
-            return octave_value_list();
-        }  
+        // get scratch memory for the peak finding algorithms
+        double* peaks = XtractOctave::getScratch (XtractOctave::peaksBuffer, paddedLength);
+        double* harmonics = XtractOctave::getScratch (XtractOctave::harmonicsBuffer, paddedLength);
+
+        // a pointer to point to the peak data which will be used
+        double* spectrumDataToUse = allPartials ? peaks : harmonics;
 
-        // find tristimulus
-        double tristimulus = 0;
-        double tristimulusExtracted;
+        Matrix output (numOrders, numFrames);
+        bool calculationFailed = false;
 
-        switch (order)
+        for (int frame = 0; frame < numFrames; ++frame)
         {
-            case 1:
-                tristimulusExtracted = xtract_tristimulus_1 (spectrumDataToUse, paddedLength / 2, NULL, &tristimulus);
-                break;
+            OCTAVE_QUIT;
+
+            // find the spectrum
+            const double* spectrum = analyser.findSpectrum (frame);
+
+            // find spectral peaks
+            peakPicker.findPeaks (spectrum, peaks);
+
+            if (! allPartials)
+            {
+                // find harmonics
+                double argumentArray [2] = {f0 [frame], threshold};
+                xtract_harmonic_spectrum (peaks, peakSpectrumLength, argumentArray, harmonics);
+            }
 
-            case 2:
-                tristimulusExtracted = xtract_tristimulus_2 (spectrumDataToUse, paddedLength / 2, NULL, &tristimulus);
-                break;
+            // find tristimulus, every order comes from the same partials
+            for (int order = firstOrder; order <= lastOrder; ++order)
+            {
+                double tristimulus = 0;
+                if (tristimulusFunctions [order - 1] (spectrumDataToUse, peakSpectrumLength / 2, NULL, &tristimulus) != XTRACT_SUCCESS)
+                {
+                    calculationFailed = true;
+                }
 
-            case 3:
-                tristimulusExtracted = xtract_tristimulus_3 (spectrumDataToUse, paddedLength / 2, NULL, &tristimulus);
-                break;
+                output (order - firstOrder, frame) = tristimulus;
+            }
         }
 
         // notify the user if the calculation failed
-        if (tristimulusExtracted != XTRACT_SUCCESS)
+        if (calculationFailed)
         {
             octave_stdout << "Tristimulus Calculation Failed\n";
         }
 
-        return octave_value (tristimulus);
+        return numOrders == 1 ? octave_value (output) : XtractOctave::packResults (output);
     }
 }
@@ -23,38 +23,65 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/f0_tracker.h"
+#include "common/frames.h"
 
 DEFUN_DLD (xtract_wavelet_f0, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_wavelet_f0 (@var{data}, @var{fs})\n"
+"@deftypefnx {Function File} {} xtract_wavelet_f0 (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Estimate the fundamental frequency of the signal @var{data} with sample rate @var{fs}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_wavelet_f0 function.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the fundamental frequency of each frame is returned. Each frame is analysed independently, use xtract_f0_tracker to carry the tracker state from one frame to the next.\n"
+"\n"
+"The \"framesize\" and \"hopsize\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
     // make sure the correct amount of arguments have been passed
-    if (args.length() != 2)
+    if (numArgs != 2)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        int inputLength = input.length();
-        const double* inputData = input.data();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+
+        if (frames.isSpectrum())
+        {
+            error ("xtract_wavelet_f0: DATA must be a signal rather than a spectrum");
+            return octave_value_list();
+        }
+
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
 
         // get the sample rate
         double sampleRate = args (1).double_value();
 
-        // initialise wavelet stuff
-        xtract_init_wavelet_f0_state();
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            // initialise wavelet stuff, each frame is independent
+            XtractOctave::resetWaveletF0State();
+
+            // find f0
+            double f0 = 0;
+            xtract_wavelet_f0(frames.getFrame (frame), inputLength, &sampleRate, &f0);
 
-        // find f0
-        double f0 = 0;
-        int firstExtractionResult = xtract_wavelet_f0(inputData, inputLength, &sampleRate, &f0);
+            output (frame) = f0;
+        }
 
-        return octave_value (f0);
+        return octave_value (output);
     }
 }
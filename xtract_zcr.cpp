@@ -23,31 +23,57 @@
 
 #include <octave/oct.h>
 #include <xtract/libxtract.h>
+#include "common/frames.h"
 
 DEFUN_DLD (xtract_zcr, args, nargout,
 "-*- texinfo -*-\n"
 "@deftypefn {Function File} {} xtract_zcr (@var{data})\n"
+"@deftypefnx {Function File} {} xtract_zcr (@dots{}, @var{option}, @var{value}, @dots{})\n"
 "Calculate the zero crossing rate of the signal @var{data}.\n"
 "\n"
 "A wrapper for LibXtract\'s xtract_zcr function.\n"
+"\n"
+"If @var{data} is a matrix each column is treated as a separate frame and a row vector containing the zero crossing rate of each frame is returned.\n"
+"\n"
+"The \"framesize\" and \"hopsize\" options can be given as @var{option}, @var{value} pairs after the other arguments, as described in the README.\n"
 "@end deftypefn\n")
 {
-    if (args.length() != 1)
+    // split any options off the end of the arguments
+    XtractOctave::Options options;
+    int numArgs = XtractOctave::parseOptions (args, options);
+
+    if (numArgs != 1)
     {
         print_usage();
         return octave_value_list();
     }
     else
     {
-        // get the input data
-        RowVector input = args (0).row_vector_value();
-        const double* inputData = input.data();
-        int inputLength = input.length();
+        // get the input frames
+        XtractOctave::Frames frames (args (0), options);
+
+        if (frames.isSpectrum())
+        {
+            error ("xtract_zcr: DATA must be a signal rather than a spectrum");
+            return octave_value_list();
+        }
+
+        int numFrames = frames.getNumFrames();
+        int inputLength = frames.getFrameLength();
+
+        RowVector output (numFrames);
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            OCTAVE_QUIT;
+
+            // get zero crossing rate
+            double zcr = 0;
+            xtract_zcr (frames.getFrame (frame), inputLength, NULL, &zcr);
 
-        // get zero crossing rate
-        double zcr = 0;
-        xtract_zcr (inputData, inputLength, NULL, &zcr);
+            output (frame) = zcr;
+        }
 
-        return octave_value (zcr);
+        return octave_value (output);
     }
 }